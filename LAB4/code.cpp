@@ -7,6 +7,24 @@
 #include <queue>
 #include <stack>
 #include <algorithm>
+#include <cstdint>
+#include <unordered_set>
+#include <memory>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <climits>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 
 using namespace std;
 
@@ -129,7 +147,18 @@ public:
     }
 };
 
-// Функция для генерации случайного графа
+// Генераторы с ограничениями степеней могут вернуть меньше рёбер, чем запрошено:
+// печатает запрошенное и полученное число рёбер и предупреждение о нехватке
+void reportEdgeShortfall(const string& name, long long requested, long long produced) {
+    if (produced < requested) {
+        cout << "Warning: " << name << " requested E=" << requested << ", produced E=" << produced
+             << " (" << requested - produced << " edges short due to degree limits)\n";
+    }
+}
+
+// Функция для генерации случайного графа.
+// Если ограничения степеней не позволяют добавить e рёбер за max_attempts попыток, граф
+// возвращается с меньшим числом рёбер — вызывающий код сообщает об этом через reportEdgeShortfall
 Graph generateRandomGraph(int v, int e, int max_edges_per_vertex, bool is_directed, int max_in_edges, int max_out_edges) {
     // Инициализация генератора случайных чисел
     random_device rd; // Источник случайности
@@ -151,7 +180,7 @@ Graph generateRandomGraph(int v, int e, int max_edges_per_vertex, bool is_direct
 
     // Переменные для контроля процесса добавления рёбер
     int attempts = 0; // Счётчик попыток добавления рёбер
-    int max_attempts = 10000; // Максимальное число попыток, чтобы избежать бесконечного цикла
+    int max_attempts = max(10000, 20 * e); // Максимальное число попыток растёт с e, чтобы большие графы не обрезались
     int added_edges = 0; // Счётчик успешно добавленных рёбер
 
     // Основной цикл: пытаемся добавить рёбра, пока не достигнем целевого числа e или не превысим max_attempts
@@ -191,12 +220,413 @@ Graph generateRandomGraph(int v, int e, int max_edges_per_vertex, bool is_direct
         added_edges++; // Увеличиваем счётчик добавленных рёбер
     }
 
-    // Если не удалось добавить все рёбра за max_attempts попыток, граф всё равно возвращается
     return graph; // Возвращаем сгенерированный граф
 }
 
+// Заголовок двоичного файла с графом. За ним подряд идут: offsets (vertices + 1 чисел int64),
+// targets (target_count чисел int32) и, если установлен флаг весов, weights (target_count чисел int32).
+// Размер заголовка кратен 8, поэтому массив offsets в отображённом файле выровнен.
+struct CompactGraphHeader {
+    char magic[8];          // Сигнатура формата "LAB4CSR1"
+    uint32_t version;       // Версия формата
+    uint32_t flags;         // Бит 0 — граф направленный, бит 1 — есть веса рёбер
+    int64_t vertices;       // Количество вершин
+    int64_t edge_count;     // Количество рёбер
+    int64_t target_count;   // Длина массива targets (для ненаправленного графа 2 * edge_count)
+};
+
+// Компактный граф в формате CSR (Compressed Sparse Row): соседи вершины v лежат
+// подряд в targets[offsets[v] .. offsets[v + 1]). Используется для больших графов,
+// где матрицы смежности и инцидентности класса Graph не помещаются в память.
+// Массивы либо принадлежат объекту, либо указывают прямо в отображённый в память файл.
+class CompactGraph {
+private:
+    int vertices = 0; // Количество вершин
+    bool is_directed = false; // Флаг направленности
+    long long edge_count = 0; // Количество рёбер (для ненаправленного графа каждое ребро считается один раз)
+    vector<long long> offsets; // Смещения начала списка соседей каждой вершины (размер vertices + 1)
+    vector<int> targets; // Соседи всех вершин подряд
+    vector<int> weights; // Веса рёбер параллельно targets (пусто, если граф невзвешенный)
+
+    // Данные графа, загруженного через mmap (nullptr, если массивы хранятся в векторах)
+    shared_ptr<void> mapping; // Владеет отображением файла, освобождает его при уничтожении последней копии
+    const long long* mapped_offsets = nullptr;
+    const int* mapped_targets = nullptr;
+    const int* mapped_weights = nullptr;
+
+    CompactGraph() = default; // Пустой граф для загрузчиков
+
+    [[nodiscard]] const long long* offsetData() const { return mapping ? mapped_offsets : offsets.data(); }
+    [[nodiscard]] const int* targetData() const { return mapping ? mapped_targets : targets.data(); }
+    [[nodiscard]] const int* weightData() const {
+        if (mapping) return mapped_weights;
+        return weights.empty() ? nullptr : weights.data();
+    }
+
+public:
+    // Диапазон соседей вершины, позволяет писать for (int v : g.getAdjList(u))
+    struct NeighborRange {
+        const int* first;
+        const int* last;
+        [[nodiscard]] const int* begin() const { return first; }
+        [[nodiscard]] const int* end() const { return last; }
+        [[nodiscard]] size_t size() const { return last - first; }
+    };
+
+    // Построение CSR из списка рёбер подсчётом степеней (O(V + E)).
+    // edge_weights либо пуст, либо содержит вес для каждого ребра из edges.
+    CompactGraph(int v, bool dir, const vector<pair<int, int>>& edges, const vector<int>& edge_weights = {})
+            : vertices(v), is_directed(dir), edge_count(edges.size()), offsets(v + 1, 0) {
+        // Считаем степени вершин
+        for (auto& [from, to] : edges) {
+            offsets[from + 1]++;
+            if (!is_directed) offsets[to + 1]++;
+        }
+        // Префиксные суммы превращают степени в смещения
+        for (int i = 0; i < vertices; ++i) offsets[i + 1] += offsets[i];
+
+        targets.resize(offsets[vertices]);
+        if (!edge_weights.empty()) weights.resize(offsets[vertices]);
+        vector<long long> pos(offsets.begin(), offsets.end() - 1); // Текущая позиция записи для каждой вершины
+        for (size_t i = 0; i < edges.size(); ++i) {
+            auto [from, to] = edges[i];
+            if (!weights.empty()) weights[pos[from]] = edge_weights[i];
+            targets[pos[from]++] = to;
+            if (!is_directed) {
+                if (!weights.empty()) weights[pos[to]] = edge_weights[i];
+                targets[pos[to]++] = from;
+            }
+        }
+    }
+
+    // Получение количества вершин
+    [[nodiscard]] int getVertices() const { return vertices; }
+
+    // Получение количества рёбер
+    [[nodiscard]] long long getEdgeCount() const { return edge_count; }
+
+    // Является ли граф направленным
+    [[nodiscard]] bool isDirected() const { return is_directed; }
+
+    // Есть ли у рёбер веса
+    [[nodiscard]] bool hasWeights() const { return weightData() != nullptr; }
+
+    // Получение соседей заданной вершины
+    [[nodiscard]] NeighborRange getAdjList(int v) const {
+        const long long* off = offsetData();
+        return {targetData() + off[v], targetData() + off[v + 1]};
+    }
+
+    // Веса рёбер к соседям вершины v в том же порядке, что и getAdjList(v) (nullptr без весов)
+    [[nodiscard]] const int* getAdjWeights(int v) const {
+        const int* w = weightData();
+        return w ? w + offsetData()[v] : nullptr;
+    }
+
+    // Запись графа в двоичный файл (формат описан в CompactGraphHeader)
+    void saveBinary(const string& filename) const {
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) throw runtime_error("Failed to open " + filename + " for writing");
+
+        CompactGraphHeader header{};
+        memcpy(header.magic, "LAB4CSR1", 8);
+        header.version = 1;
+        header.flags = (is_directed ? 1u : 0u) | (hasWeights() ? 2u : 0u);
+        header.vertices = vertices;
+        header.edge_count = edge_count;
+        header.target_count = offsetData()[vertices];
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(offsetData()), (vertices + 1) * sizeof(long long));
+        file.write(reinterpret_cast<const char*>(targetData()), header.target_count * sizeof(int));
+        if (hasWeights()) file.write(reinterpret_cast<const char*>(weightData()), header.target_count * sizeof(int));
+        if (!file) throw runtime_error("Failed to write " + filename);
+    }
+
+    // Загрузка графа из двоичного файла без копирования: файл отображается в память,
+    // а массивы графа указывают прямо в отображение. На Windows файл читается целиком.
+    static CompactGraph loadBinary(const string& filename) {
+        CompactGraph g;
+#ifdef _WIN32
+        ifstream file(filename, ios::binary | ios::ate);
+        if (!file.is_open()) throw runtime_error("Failed to open " + filename);
+        size_t file_size = file.tellg();
+        file.seekg(0);
+        shared_ptr<char[]> buffer(new char[file_size]);
+        if (!file.read(buffer.get(), file_size)) throw runtime_error("Failed to read " + filename);
+        const char* data = buffer.get();
+        g.mapping = buffer;
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("Failed to open " + filename);
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw runtime_error("Failed to stat " + filename);
+        }
+        size_t file_size = st.st_size;
+        if (file_size < sizeof(CompactGraphHeader)) {
+            close(fd);
+            throw runtime_error(filename + " is too small to be a graph file");
+        }
+        void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // Отображение остаётся действительным и после закрытия дескриптора
+        if (addr == MAP_FAILED) throw runtime_error("Failed to mmap " + filename);
+        g.mapping = shared_ptr<void>(addr, [file_size](void* p) { munmap(p, file_size); });
+        const char* data = static_cast<const char*>(addr);
+#endif
+        CompactGraphHeader header{};
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, "LAB4CSR1", 8) != 0 || header.version != 1)
+            throw runtime_error(filename + " is not a LAB4 graph file");
+
+        // Файлу нельзя доверять: массивы используются без копирования, и любая ошибка
+        // в размерах или смещениях превратилась бы в чтение за пределами отображения
+        if (header.vertices < 0 || header.vertices > INT_MAX || header.edge_count < 0 || header.target_count < 0)
+            throw runtime_error(filename + " has invalid vertex or edge counts");
+        bool weighted = header.flags & 2u;
+        // Размеры сравниваются делением, чтобы произведения не переполнялись
+        size_t payload = file_size - sizeof(header);
+        size_t offsets_size = (size_t(header.vertices) + 1) * sizeof(long long);
+        if (payload < offsets_size ||
+            uint64_t(header.target_count) > (payload - offsets_size) / (sizeof(int) * (weighted ? 2 : 1)))
+            throw runtime_error(filename + " is truncated");
+
+        const long long* offsets = reinterpret_cast<const long long*>(data + sizeof(header));
+        const int* targets = reinterpret_cast<const int*>(offsets + header.vertices + 1);
+        int v_count = int(header.vertices);
+        // Один проход O(V + E): смещения не убывают и заканчиваются на target_count, соседи — вершины графа
+        if (offsets[0] != 0 || offsets[v_count] != header.target_count)
+            throw runtime_error(filename + " has inconsistent offsets");
+        for (int v = 0; v < v_count; ++v) {
+            if (offsets[v + 1] < offsets[v]) throw runtime_error(filename + " has decreasing offsets");
+        }
+        for (int64_t i = 0; i < header.target_count; ++i) {
+            if (targets[i] < 0 || targets[i] >= v_count) throw runtime_error(filename + " has an out-of-range vertex");
+        }
+
+        g.vertices = v_count;
+        g.is_directed = header.flags & 1u;
+        g.edge_count = header.edge_count;
+        g.mapped_offsets = offsets;
+        g.mapped_targets = targets;
+        g.mapped_weights = weighted ? targets + header.target_count : nullptr;
+        return g;
+    }
+
+    // Импорт графа из текстового списка рёбер: по одному ребру "from to [weight]" в строке,
+    // строки, начинающиеся с '#' или '%', считаются комментариями. Число вершин равно
+    // максимальному номеру вершины + 1. Веса учитываются, только если указаны во всех строках.
+    static CompactGraph loadEdgeList(const string& filename, bool is_directed) {
+        ifstream file(filename);
+        if (!file.is_open()) throw runtime_error("Failed to open " + filename);
+
+        vector<pair<int, int>> edges;
+        vector<int> edge_weights;
+        bool all_weighted = true;
+        int max_vertex = -1;
+        string line;
+        while (getline(file, line)) {
+            if (line.empty() || line[0] == '#' || line[0] == '%') continue;
+            istringstream in(line);
+            int from, to, weight;
+            if (!(in >> from >> to)) continue; // Пропускаем строки, которые не похожи на ребро
+            if (from < 0 || to < 0) throw runtime_error("Negative vertex id in " + filename);
+            if (in >> weight) edge_weights.push_back(weight);
+            else all_weighted = false;
+            edges.emplace_back(from, to);
+            max_vertex = max(max_vertex, max(from, to));
+        }
+        if (!all_weighted) edge_weights.clear();
+        return CompactGraph(max_vertex + 1, is_directed, edges, edge_weights);
+    }
+};
+
+// Семейства случайных графов для генератора generateCompactGraph
+enum class GraphFamily {
+    ErdosRenyi, // Равномерно случайные рёбра с ограничением степеней (модель конфигураций)
+    RMat,       // Рекурсивная матрица (R-MAT): степенное распределение степеней, как в реальных сетях
+    Grid        // Двумерная решётка: каждая вершина связана с правым и нижним соседом
+};
+
+// Случайное сопоставление "заглушек": дописывает в edges рёбра, пока их не станет e.
+// Вершина встречается в пуле столько раз, сколько рёбер ей ещё разрешено; для ненаправленного
+// графа используется только out_stubs. Израсходованные заглушки больше не выбираются, поэтому
+// ограничения степеней соблюдаются автоматически, а каждая попытка стоит O(1).
+// Петли и рёбра, уже записанные в existing, отбрасываются.
+void matchStubs(vector<int>& out_stubs, vector<int>& in_stubs, long long e, bool is_directed,
+                unordered_set<uint64_t>& existing, vector<pair<int, int>>& edges, mt19937_64& gen) {
+    // Больше рёбер, чем позволяют заглушки, получить нельзя
+    long long max_possible = (long long)edges.size() +
+        (is_directed ? min((long long)out_stubs.size(), (long long)in_stubs.size()) : (long long)out_stubs.size() / 2);
+    e = min(e, max_possible);
+    if ((long long)edges.size() >= e) return;
+    edges.reserve(e);
+
+    // Выбирает случайную заглушку из неиспользованной части пула [used, size) и ставит её на позицию used
+    auto draw = [&gen](vector<int>& pool, size_t used) {
+        uniform_int_distribution<size_t> pick(used, pool.size() - 1);
+        swap(pool[used], pool[pick(gen)]);
+        return pool[used];
+    };
+
+    size_t out_used = 0, in_used = 0; // Длины израсходованных префиксов пулов
+    long long failures = 0, max_failures = 4 * (e - (long long)edges.size()) + 1000; // Ограничение на число неудачных сопоставлений
+    while ((long long)edges.size() < e && failures < max_failures) {
+        int from, to;
+        if (is_directed) {
+            from = draw(out_stubs, out_used);
+            to = draw(in_stubs, in_used);
+        } else {
+            if (out_used + 2 > out_stubs.size()) break;
+            from = draw(out_stubs, out_used);
+            to = draw(out_stubs, out_used + 1);
+        }
+
+        // Ключ ребра; для ненаправленного графа (a, b) и (b, a) — одно ребро
+        int a = is_directed ? from : min(from, to);
+        int b = is_directed ? to : max(from, to);
+        uint64_t key = (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+        if (from == to || !existing.insert(key).second) {
+            failures++; // Заглушки остаются в пуле и могут быть выбраны снова
+            continue;
+        }
+
+        edges.emplace_back(from, to);
+        if (is_directed) {
+            out_used++;
+            in_used++;
+        } else {
+            out_used += 2;
+        }
+    }
+}
+
+// Генерация рёбер методом сопоставления "заглушек" (stub matching) с ограничением степеней.
+// Каждая вершина получает max_out_edges исходящих и max_in_edges входящих заглушек
+// (для ненаправленного графа — max_out_edges общих), затем заглушки случайно соединяются.
+vector<pair<int, int>> generateStubMatchingEdges(int v, long long e, bool is_directed, int max_out_edges, int max_in_edges, mt19937_64& gen) {
+    vector<pair<int, int>> edges;
+    if (v <= 1) return edges;
+
+    // Пулы заглушек: вершина i встречается в пуле столько раз, сколько рёбер ей разрешено
+    int out_cap = max_out_edges;
+    int in_cap = is_directed ? max_in_edges : max_out_edges;
+    vector<int> out_stubs, in_stubs;
+    out_stubs.reserve((size_t)v * out_cap);
+    for (int i = 0; i < v; ++i) out_stubs.insert(out_stubs.end(), out_cap, i);
+    if (is_directed) {
+        in_stubs.reserve((size_t)v * in_cap);
+        for (int i = 0; i < v; ++i) in_stubs.insert(in_stubs.end(), in_cap, i);
+    }
+
+    unordered_set<uint64_t> existing; // Уже добавленные рёбра для отсева дубликатов
+    existing.reserve(min(e, (long long)out_stubs.size()) * 2);
+    matchStubs(out_stubs, in_stubs, e, is_directed, existing, edges, gen);
+    return edges;
+}
+
+// Генерация рёбер R-MAT: каждое ребро выбирается рекурсивным спуском по квадрантам
+// матрицы смежности с вероятностями (a, b, c, d). Ограничения степеней проверяются
+// по счётчикам, число попыток пропорционально e. Из-за перекоса R-MAT вершины-"хабы" быстро
+// упираются в ограничения и попытки кончаются раньше, чем набирается e рёбер; остаток
+// добирается сопоставлением заглушек среди вершин с неизрасходованной степенью.
+vector<pair<int, int>> generateRMatEdges(int v, long long e, bool is_directed, int max_out_edges, int max_in_edges, mt19937_64& gen) {
+    // Классические параметры R-MAT a = 0.57, b = 0.19, c = 0.19 (d = 0.05) в виде порогов
+    // для 32-битного случайного числа: одно 64-битное число обслуживает два уровня рекурсии
+    const uint64_t a = 0.57 * 4294967296.0, ab = 0.76 * 4294967296.0, abc = 0.95 * 4294967296.0;
+    vector<pair<int, int>> edges;
+    if (v <= 1) return edges;
+
+    int scale = 0; // Число уровней рекурсии: 2^scale >= v
+    while ((1LL << scale) < v) scale++;
+
+    vector<int> out_degrees(v, 0), in_degrees(v, 0);
+    unordered_set<uint64_t> existing;
+    existing.reserve(e * 2);
+    edges.reserve(e);
+
+    long long attempts = 0, max_attempts = 4 * e + 1000;
+    while ((long long)edges.size() < e && attempts < max_attempts) {
+        attempts++;
+        long long from = 0, to = 0;
+        uint64_t bits = 0;
+        for (int level = 0; level < scale; ++level) {
+            if (level % 2 == 0) bits = gen();
+            uint64_t r = bits & 0xffffffffULL; // Очередные 32 случайных бита
+            bits >>= 32;
+            from <<= 1;
+            to <<= 1;
+            if (r < a) {} // Левый верхний квадрант
+            else if (r < ab) to |= 1; // Правый верхний
+            else if (r < abc) from |= 1; // Левый нижний
+            else { from |= 1; to |= 1; } // Правый нижний
+        }
+        if (from >= v || to >= v || from == to) continue; // Вне диапазона (v не степень двойки) или петля
+
+        int f = (int)from, t = (int)to;
+        // Для ненаправленного графа степень общая и ограничена max_out_edges
+        if (is_directed ? (out_degrees[f] >= max_out_edges || in_degrees[t] >= max_in_edges)
+                        : (out_degrees[f] >= max_out_edges || out_degrees[t] >= max_out_edges)) continue;
+
+        int ka = is_directed ? f : min(f, t);
+        int kb = is_directed ? t : max(f, t);
+        if (!existing.insert((uint64_t(uint32_t(ka)) << 32) | uint32_t(kb)).second) continue;
+
+        edges.emplace_back(f, t);
+        out_degrees[f]++;
+        if (is_directed) in_degrees[t]++;
+        else out_degrees[t]++;
+    }
+
+    if ((long long)edges.size() < e) {
+        // Пулы из оставшейся ёмкости вершин; для ненаправленного графа степень общая
+        vector<int> out_stubs, in_stubs;
+        for (int i = 0; i < v; ++i) {
+            out_stubs.insert(out_stubs.end(), max(0, max_out_edges - out_degrees[i]), i);
+            if (is_directed) in_stubs.insert(in_stubs.end(), max(0, max_in_edges - in_degrees[i]), i);
+        }
+        matchStubs(out_stubs, in_stubs, e, is_directed, existing, edges, gen);
+    }
+    return edges;
+}
+
+// Генерация рёбер двумерной решётки примерно sqrt(v) x sqrt(v)
+vector<pair<int, int>> generateGridEdges(int v) {
+    vector<pair<int, int>> edges;
+    int cols = 1;
+    while ((long long)cols * cols < v) cols++;
+    edges.reserve(2LL * v);
+    for (int id = 0; id < v; ++id) {
+        if ((id + 1) % cols != 0 && id + 1 < v) edges.emplace_back(id, id + 1); // Правый сосед
+        if (id + cols < v) edges.emplace_back(id, id + cols); // Нижний сосед
+    }
+    return edges;
+}
+
+// Генерация большого случайного графа сразу в компактном представлении за ожидаемое O(E).
+// Для решётки параметры e и ограничения степеней не используются (степень не больше 4).
+CompactGraph generateCompactGraph(GraphFamily family, int v, long long e, bool is_directed, int max_out_edges, int max_in_edges, uint64_t seed) {
+    mt19937_64 gen(seed);
+    vector<pair<int, int>> edges;
+    switch (family) {
+        case GraphFamily::ErdosRenyi:
+            edges = generateStubMatchingEdges(v, e, is_directed, max_out_edges, max_in_edges, gen);
+            break;
+        case GraphFamily::RMat:
+            edges = generateRMatEdges(v, e, is_directed, max_out_edges, max_in_edges, gen);
+            break;
+        case GraphFamily::Grid:
+            edges = generateGridEdges(v);
+            break;
+    }
+    return CompactGraph(v, is_directed, edges);
+}
+
 // Поиск в ширину (BFS) для нахождения кратчайшего пути между start и end
-int bfs(Graph& g, int start, int end, vector<int>& path) {
+// Работает как с Graph, так и с CompactGraph
+template <typename GraphType>
+int bfs(GraphType& g, int start, int end, vector<int>& path) {
     int v_count = g.getVertices(); // Получаем количество вершин
     vector<int> distance(v_count, -1); // Массив расстояний: -1 означает, что вершина не посещена
     vector<int> parent(v_count, -1); // Массив родителей для восстановления пути
@@ -234,7 +664,9 @@ int bfs(Graph& g, int start, int end, vector<int>& path) {
 }
 
 // Поиск в глубину (DFS) для нахождения пути между start и end
-int dfs(Graph& g, int start, int end, vector<int>& path) {
+// Работает как с Graph, так и с CompactGraph
+template <typename GraphType>
+int dfs(GraphType& g, int start, int end, vector<int>& path) {
     int v_count = g.getVertices(); // Получаем количество вершин
     vector<bool> visited(v_count, false); // Массив посещённых вершин
     vector<int> parent(v_count, -1); // Массив родителей для восстановления пути
@@ -253,11 +685,10 @@ int dfs(Graph& g, int start, int end, vector<int>& path) {
 
         if (!visited[u]) { // Если вершина u ещё не посещена
             visited[u] = true; // Помечаем её как посещённую
-            // Получаем соседей вершины u
-            vector<int> neighbors = g.getAdjList(u);
-            // Разворачиваем соседей, чтобы порядок обхода был более предсказуемым
-            reverse(neighbors.begin(), neighbors.end());
-            for (int v : neighbors) { // Перебираем соседей
+            // Перебираем соседей в обратном порядке, чтобы первым из стека извлекался первый сосед
+            const auto& neighbors = g.getAdjList(u);
+            for (auto it = neighbors.end(); it != neighbors.begin();) {
+                int v = *--it;
                 if (!visited[v]) { // Если сосед v не посещён
                     parent[v] = u; // Сохраняем родителя v для восстановления пути
                     s.push(v); // Добавляем v в стек
@@ -281,6 +712,341 @@ int dfs(Graph& g, int start, int end, vector<int>& path) {
     return path.size() - 1; // Возвращаем длину пути
 }
 
+// Пакетный BFS сразу из нескольких стартовых вершин (до 64 за один проход).
+// Для каждой вершины храним 64-битные маски: бит k означает, что источник k пакета
+// уже видел вершину (seen) или она находится на текущем фронте (frontier).
+// Один обход списков смежности на уровень обслуживает весь пакет источников.
+// Возвращает матрицу расстояний: result[i][v] — расстояние от sources[i] до v (-1, если недостижима).
+template <typename GraphType>
+vector<vector<int>> multiSourceBfs(GraphType& g, const vector<int>& sources) {
+    const int batch_size = 64; // Количество источников в одном пакете (бит в uint64_t)
+    int v_count = g.getVertices();
+    vector<vector<int>> result(sources.size(), vector<int>(v_count, -1));
+
+    vector<uint64_t> seen(v_count), frontier(v_count), next(v_count);
+    for (size_t base = 0; base < sources.size(); base += batch_size) {
+        size_t count = min(sources.size() - base, (size_t)batch_size); // Размер текущего пакета
+        fill(seen.begin(), seen.end(), 0);
+        fill(frontier.begin(), frontier.end(), 0);
+
+        // Начальный фронт: каждый источник виден сам себе на расстоянии 0
+        for (size_t k = 0; k < count; ++k) {
+            int s = sources[base + k];
+            seen[s] |= uint64_t(1) << k;
+            frontier[s] |= uint64_t(1) << k;
+            result[base + k][s] = 0;
+        }
+
+        bool active = true;
+        for (int level = 1; active; ++level) {
+            active = false;
+            fill(next.begin(), next.end(), 0);
+
+            // Распространяем фронт: биты вершины u переходят ко всем её соседям
+            for (int u = 0; u < v_count; ++u) {
+                uint64_t bits = frontier[u];
+                if (!bits) continue; // Вершина не на фронте ни для одного источника
+                for (int v : g.getAdjList(u)) next[v] |= bits;
+            }
+
+            // Оставляем только новые биты и записываем расстояния
+            for (int v = 0; v < v_count; ++v) {
+                uint64_t fresh = next[v] & ~seen[v];
+                frontier[v] = fresh;
+                if (!fresh) continue;
+                seen[v] |= fresh;
+                active = true;
+                while (fresh) {
+                    int k = __builtin_ctzll(fresh); // Номер источника в пакете
+                    result[base + k][v] = level;
+                    fresh &= fresh - 1; // Сбрасываем младший установленный бит
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Итеративный обход в глубину с явным стеком кадров (без рекурсии и без копирования соседей).
+// Кадр хранит вершину, её родителя и позицию в списке соседей, поэтому обход продолжается
+// ровно с того места, где остановился. Обратные вызовы:
+//   on_pre(u, parent)        — вершина u впервые посещена (прямой порядок)
+//   on_edge(u, v, parent)    — ребро u -> v ведёт в уже посещённую вершину v (не древесное ребро)
+//   on_post(u, parent)       — все потомки u обработаны (обратный порядок)
+// visited общий для нескольких запусков, что позволяет обойти весь граф из разных корней.
+template <typename GraphType, typename PreVisit, typename EdgeVisit, typename PostVisit>
+void dfsTraverse(GraphType& g, int root, vector<char>& visited, PreVisit on_pre, EdgeVisit on_edge, PostVisit on_post) {
+    using Iter = decltype(g.getAdjList(0).begin());
+    struct Frame {
+        int vertex; // Текущая вершина
+        int parent; // Родитель в дереве обхода (-1 для корня)
+        Iter next;  // Следующий непросмотренный сосед
+        Iter end;   // Конец списка соседей
+    };
+    vector<Frame> frames;
+
+    visited[root] = 1;
+    on_pre(root, -1);
+    auto&& root_adj = g.getAdjList(root);
+    frames.push_back({root, -1, root_adj.begin(), root_adj.end()});
+
+    while (!frames.empty()) {
+        Frame& f = frames.back();
+        if (f.next != f.end) {
+            int u = f.vertex;
+            int v = *f.next++;
+            if (!visited[v]) { // Древесное ребро: спускаемся в v
+                visited[v] = 1;
+                on_pre(v, u);
+                auto&& adj = g.getAdjList(v);
+                frames.push_back({v, u, adj.begin(), adj.end()}); // Ссылка f после этого недействительна
+            } else {
+                on_edge(u, v, f.parent);
+            }
+        } else { // Соседи закончились: выходим из вершины
+            int u = f.vertex, parent = f.parent;
+            frames.pop_back();
+            on_post(u, parent);
+        }
+    }
+}
+
+// Компоненты сильной связности алгоритмом Тарьяна за O(V + E).
+// Возвращает номер компоненты для каждой вершины, число компонент записывается в component_count.
+template <typename GraphType>
+vector<int> stronglyConnectedComponents(GraphType& g, int& component_count) {
+    int v_count = g.getVertices();
+    vector<int> index(v_count, -1), low(v_count, 0), component(v_count, -1);
+    vector<char> visited(v_count, 0), on_stack(v_count, 0);
+    vector<int> scc_stack; // Стек вершин текущих незавершённых компонент
+    int counter = 0;
+    component_count = 0;
+
+    for (int root = 0; root < v_count; ++root) {
+        if (visited[root]) continue;
+        dfsTraverse(g, root, visited,
+            [&](int u, int) {
+                index[u] = low[u] = counter++;
+                scc_stack.push_back(u);
+                on_stack[u] = 1;
+            },
+            [&](int u, int v, int) {
+                if (on_stack[v]) low[u] = min(low[u], index[v]);
+            },
+            [&](int u, int parent) {
+                if (low[u] == index[u]) { // u — корень компоненты: снимаем её со стека
+                    int w;
+                    do {
+                        w = scc_stack.back();
+                        scc_stack.pop_back();
+                        on_stack[w] = 0;
+                        component[w] = component_count;
+                    } while (w != u);
+                    component_count++;
+                }
+                if (parent != -1) low[parent] = min(low[parent], low[u]);
+            });
+    }
+    return component;
+}
+
+// Топологическая сортировка направленного графа (обратный порядок выхода из вершин).
+// Возвращает false, если в графе есть цикл; тогда order остаётся пустым.
+template <typename GraphType>
+bool topologicalSort(GraphType& g, vector<int>& order) {
+    int v_count = g.getVertices();
+    vector<char> visited(v_count, 0), finished(v_count, 0);
+    bool has_cycle = false;
+    order.clear();
+    order.reserve(v_count);
+
+    for (int root = 0; root < v_count && !has_cycle; ++root) {
+        if (visited[root]) continue;
+        dfsTraverse(g, root, visited,
+            [](int, int) {},
+            [&](int, int v, int) {
+                if (!finished[v]) has_cycle = true; // Ребро в вершину на текущем пути — цикл
+            },
+            [&](int u, int) {
+                finished[u] = 1;
+                order.push_back(u);
+            });
+    }
+    if (has_cycle) {
+        order.clear();
+        return false;
+    }
+    reverse(order.begin(), order.end());
+    return true;
+}
+
+// Точки сочленения ненаправленного графа (вершины, удаление которых увеличивает число компонент)
+template <typename GraphType>
+vector<int> articulationPoints(GraphType& g) {
+    int v_count = g.getVertices();
+    vector<int> tin(v_count, -1), low(v_count, 0), root_children(v_count, 0);
+    vector<char> visited(v_count, 0), is_articulation(v_count, 0);
+    int timer = 0;
+
+    for (int root = 0; root < v_count; ++root) {
+        if (visited[root]) continue;
+        dfsTraverse(g, root, visited,
+            [&](int u, int) { tin[u] = low[u] = timer++; },
+            [&](int u, int v, int parent) {
+                if (v != parent) low[u] = min(low[u], tin[v]); // Обратное ребро (ребро к родителю не считается)
+            },
+            [&](int u, int parent) {
+                if (parent == -1) return;
+                low[parent] = min(low[parent], low[u]);
+                if (parent == root) root_children[root]++;
+                else if (low[u] >= tin[parent]) is_articulation[parent] = 1;
+            });
+        if (root_children[root] > 1) is_articulation[root] = 1; // Корень — точка сочленения, если у него больше одного потомка
+    }
+
+    vector<int> result;
+    for (int v = 0; v < v_count; ++v) {
+        if (is_articulation[v]) result.push_back(v);
+    }
+    return result;
+}
+
+// Способы перенумерации вершин для улучшения локальности обхода
+enum class VertexOrdering {
+    BfsOrder,            // Порядок посещения в BFS: соседи получают близкие номера
+    ReverseCuthillMcKee, // Обратный порядок Катхилла–Макки: BFS с сортировкой соседей по степени, затем разворот
+    DegreeSort           // Сортировка по убыванию степени: "тяжёлые" вершины лежат рядом
+};
+
+// Перестановка вершин и обратное отображение
+struct VertexRelabeling {
+    vector<int> new_to_old; // new_to_old[новый номер] = исходный номер
+    vector<int> old_to_new; // old_to_new[исходный номер] = новый номер
+};
+
+// Вычисляет перестановку вершин выбранным способом за O(V + E) (для RCM — O(E log d))
+VertexRelabeling computeVertexOrdering(const CompactGraph& g, VertexOrdering ordering) {
+    int v_count = g.getVertices();
+    VertexRelabeling result;
+    result.new_to_old.reserve(v_count);
+
+    if (ordering == VertexOrdering::DegreeSort) {
+        result.new_to_old.resize(v_count);
+        for (int i = 0; i < v_count; ++i) result.new_to_old[i] = i;
+        stable_sort(result.new_to_old.begin(), result.new_to_old.end(), [&g](int a, int b) {
+            return g.getAdjList(a).size() > g.getAdjList(b).size();
+        });
+    } else {
+        bool rcm = ordering == VertexOrdering::ReverseCuthillMcKee;
+        vector<char> visited(v_count, 0);
+        vector<int> roots(v_count);
+        for (int i = 0; i < v_count; ++i) roots[i] = i;
+        // Для RCM каждую компоненту начинаем с вершины минимальной степени
+        if (rcm) {
+            stable_sort(roots.begin(), roots.end(), [&g](int a, int b) {
+                return g.getAdjList(a).size() < g.getAdjList(b).size();
+            });
+        }
+
+        vector<int> neighbors;
+        for (int root : roots) {
+            if (visited[root]) continue;
+            visited[root] = 1;
+            size_t head = result.new_to_old.size(); // Очередь BFS — хвост самого массива перестановки
+            result.new_to_old.push_back(root);
+            while (head < result.new_to_old.size()) {
+                int u = result.new_to_old[head++];
+                neighbors.clear();
+                for (int v : g.getAdjList(u)) {
+                    if (!visited[v]) {
+                        visited[v] = 1;
+                        neighbors.push_back(v);
+                    }
+                }
+                if (rcm) {
+                    sort(neighbors.begin(), neighbors.end(), [&g](int a, int b) {
+                        return g.getAdjList(a).size() < g.getAdjList(b).size();
+                    });
+                }
+                result.new_to_old.insert(result.new_to_old.end(), neighbors.begin(), neighbors.end());
+            }
+        }
+        if (rcm) reverse(result.new_to_old.begin(), result.new_to_old.end());
+    }
+
+    result.old_to_new.resize(v_count);
+    for (int i = 0; i < v_count; ++i) result.old_to_new[result.new_to_old[i]] = i;
+    return result;
+}
+
+// Строит копию графа с перенумерованными вершинами (веса рёбер сохраняются)
+CompactGraph relabelGraph(const CompactGraph& g, const VertexRelabeling& relabeling) {
+    vector<pair<int, int>> edges;
+    vector<int> edge_weights;
+    edges.reserve(g.getEdgeCount());
+    if (g.hasWeights()) edge_weights.reserve(g.getEdgeCount());
+
+    for (int u = 0; u < g.getVertices(); ++u) {
+        auto adj = g.getAdjList(u);
+        const int* w = g.getAdjWeights(u);
+        for (size_t i = 0; i < adj.size(); ++i) {
+            int v = adj.begin()[i];
+            if (!g.isDirected() && v < u) continue; // Ненаправленное ребро хранится дважды, берём один раз
+            edges.emplace_back(relabeling.old_to_new[u], relabeling.old_to_new[v]);
+            if (w) edge_weights.push_back(w[i]);
+        }
+    }
+    return CompactGraph(g.getVertices(), g.isDirected(), edges, edge_weights);
+}
+
+// Счётчик промахов последнего уровня кэша через perf_event (только Linux).
+// Если счётчик недоступен (другая ОС, нет прав, виртуальная машина), stop() возвращает -1.
+class CacheMissCounter {
+private:
+    int fd = -1; // Дескриптор счётчика perf_event
+
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMissCounter() {
+        if (fd >= 0) close(fd);
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    [[nodiscard]] bool available() const { return fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long stop() {
+#ifdef __linux__
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+};
+
 // Функция для записи данных о графах в CSV-файл
 void generateGraphData(const vector<double>& bfs_times, const vector<double>& dfs_times, const vector<int>& sizes, const vector<bool>& directed, const vector<int>& edges) {
     ofstream file("graph_data.csv"); // Открываем файл для записи
@@ -296,10 +1062,23 @@ void generateGraphData(const vector<double>& bfs_times, const vector<double>& df
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     random_device rd; // Генератор случайных чисел
     mt19937 gen(rd());
 
+    // Параметры большого графа для бенчмарков: --graph=PATH задаёт файл, --seed=S — зерно генерации.
+    // Если файл уже существует, граф загружается из него, поэтому замеры повторяются на одном и том же графе
+    string graph_path = "graph.bin";
+    uint64_t graph_seed = 42;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--graph=", 0) == 0) {
+            graph_path = arg.substr(8);
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            graph_seed = stoull(arg.substr(7));
+        }
+    }
+
     // Параметры для генерации графов
     int min_vertices = 5, max_vertices = 10; // Диапазон числа вершин
     int min_edges = 10, max_edges = 20; // Диапазон числа рёбер
@@ -345,6 +1124,7 @@ int main() {
         double bfs_time = chrono::duration<double>(bfs_end - bfs_start).count(); // Вычисляем время выполнения
         bfs_times.push_back(bfs_time); // Сохраняем время выполнения BFS
         cout << "Directed Graph " << i + 1 << " (V=" << v << ", E=" << g.getEdgeCount() << "):\n";
+        reportEdgeShortfall("Directed Graph " + to_string(i + 1), e, g.getEdgeCount());
         cout << "BFS from " << start << " to " << end << ": ";
         if (bfs_dist == -1) cout << "No path\n"; // Если пути нет
         else {
@@ -402,6 +1182,7 @@ int main() {
         double bfs_time = chrono::duration<double>(bfs_end - bfs_start).count();
         bfs_times.push_back(bfs_time);
         cout << "Undirected Graph " << i + 1 << " (V=" << v << ", E=" << g.getEdgeCount() << "):\n";
+        reportEdgeShortfall("Undirected Graph " + to_string(i + 1), e, g.getEdgeCount());
         cout << "BFS from " << start << " to " << end << ": ";
         if (bfs_dist == -1) cout << "No path\n";
         else {
@@ -459,5 +1240,185 @@ int main() {
     cout << "Average DFS time: " << avg_dfs_undirected << "s\n";
     cout << "BFS finds the shortest path efficiently, while DFS may fail if vertices are in different components.\n";
 
+    // Генерация больших графов сразу в компактном представлении
+    cout << "\nLarge graph generation (CSR):\n";
+    {
+        const char* family_names[] = {"Erdos-Renyi", "R-MAT", "Grid"};
+        GraphFamily families[] = {GraphFamily::ErdosRenyi, GraphFamily::RMat, GraphFamily::Grid};
+        int v = 1 << 18;
+        long long e = 1000000;
+        for (int f = 0; f < 3; ++f) {
+            auto gen_start = chrono::high_resolution_clock::now();
+            CompactGraph g = generateCompactGraph(families[f], v, e, true, 16, 16, gen());
+            auto gen_end = chrono::high_resolution_clock::now();
+            double gen_time = chrono::duration<double>(gen_end - gen_start).count();
+            cout << family_names[f] << ": V=" << g.getVertices() << ", E=" << g.getEdgeCount()
+                 << ", generation time: " << gen_time << "s\n";
+            // Решётка не использует параметр e
+            if (families[f] != GraphFamily::Grid) reportEdgeShortfall(family_names[f], e, g.getEdgeCount());
+        }
+    }
+
+    // Сохранение графа в двоичный файл и повторная загрузка через mmap
+    cout << "\nBinary graph storage:\n";
+    try {
+        // Генерируем и сохраняем граф, только если файла ещё нет
+        if (!ifstream(graph_path, ios::binary)) {
+            CompactGraph g = generateCompactGraph(GraphFamily::ErdosRenyi, 1 << 18, 1000000, true, 16, 16, graph_seed);
+            auto save_start = chrono::high_resolution_clock::now();
+            g.saveBinary(graph_path);
+            auto save_end = chrono::high_resolution_clock::now();
+            cout << "Generated (seed " << graph_seed << ") and saved V=" << g.getVertices() << ", E=" << g.getEdgeCount()
+                 << " to " << graph_path << " in " << chrono::duration<double>(save_end - save_start).count() << "s\n";
+        }
+
+        auto load_start = chrono::high_resolution_clock::now();
+        CompactGraph loaded = CompactGraph::loadBinary(graph_path);
+        auto load_end = chrono::high_resolution_clock::now();
+        cout << "Loaded V=" << loaded.getVertices() << ", E=" << loaded.getEdgeCount() << " from " << graph_path
+             << " in " << chrono::duration<double>(load_end - load_start).count() << "s\n";
+
+        // BFS и DFS выполняются прямо на отображённых в память массивах
+        if (loaded.getVertices() > 0) {
+            int target = loaded.getVertices() - 1;
+            vector<int> bfs_path, dfs_path;
+            auto bfs_start = chrono::high_resolution_clock::now();
+            int bfs_dist = bfs(loaded, 0, target, bfs_path);
+            auto bfs_end = chrono::high_resolution_clock::now();
+            int dfs_dist = dfs(loaded, 0, target, dfs_path);
+            auto dfs_end = chrono::high_resolution_clock::now();
+            cout << "BFS distance 0 -> " << target << ": " << bfs_dist << " ("
+                 << chrono::duration<double>(bfs_end - bfs_start).count() << "s)\n";
+            cout << "DFS path length 0 -> " << target << ": " << dfs_dist << " ("
+                 << chrono::duration<double>(dfs_end - bfs_end).count() << "s)\n";
+        }
+
+        // Импорт текстового списка рёбер с весами
+        ofstream edge_file("graph_edges.txt");
+        edge_file << "# from to weight\n0 1 5\n1 2 3\n2 0 7\n2 3 1\n";
+        edge_file.close();
+        CompactGraph imported = CompactGraph::loadEdgeList("graph_edges.txt", true);
+        cout << "Imported edge list: V=" << imported.getVertices() << ", E=" << imported.getEdgeCount()
+             << ", weighted: " << (imported.hasWeights() ? "Yes" : "No") << "\n";
+    } catch (const exception& ex) {
+        cerr << "Graph storage error: " << ex.what() << endl;
+    }
+
+    // Анализ графов на основе итеративного DFS: SCC, топологическая сортировка, точки сочленения
+    cout << "\nDFS-based analyses:\n";
+    {
+        int v = 1 << 18;
+        long long e = 1000000;
+        mt19937_64 edge_gen(gen());
+
+        CompactGraph directed = generateCompactGraph(GraphFamily::ErdosRenyi, v, e, true, 16, 16, gen());
+        int component_count = 0;
+        auto scc_start = chrono::high_resolution_clock::now();
+        vector<int> component = stronglyConnectedComponents(directed, component_count);
+        auto scc_end = chrono::high_resolution_clock::now();
+        cout << "SCC (V=" << v << ", E=" << directed.getEdgeCount() << "): " << component_count << " components, "
+             << chrono::duration<double>(scc_end - scc_start).count() << "s\n";
+
+        // Ациклический граф: ориентируем каждое ребро от меньшего номера к большему
+        vector<pair<int, int>> dag_edges = generateStubMatchingEdges(v, e, false, 16, 16, edge_gen);
+        for (auto& [from, to] : dag_edges) {
+            if (from > to) swap(from, to);
+        }
+        CompactGraph dag(v, true, dag_edges);
+        vector<int> order;
+        auto topo_start = chrono::high_resolution_clock::now();
+        bool is_dag = topologicalSort(dag, order);
+        auto topo_end = chrono::high_resolution_clock::now();
+        cout << "Topological sort (V=" << v << ", E=" << dag.getEdgeCount() << "): "
+             << (is_dag ? "ok" : "cycle found") << ", "
+             << chrono::duration<double>(topo_end - topo_start).count() << "s\n";
+
+        CompactGraph undirected = generateCompactGraph(GraphFamily::ErdosRenyi, v, e / 2, false, 8, 8, gen());
+        auto art_start = chrono::high_resolution_clock::now();
+        vector<int> points = articulationPoints(undirected);
+        auto art_end = chrono::high_resolution_clock::now();
+        cout << "Articulation points (V=" << v << ", E=" << undirected.getEdgeCount() << "): " << points.size() << ", "
+             << chrono::duration<double>(art_end - art_start).count() << "s\n";
+    }
+
+    // Влияние перенумерации вершин на локальность обхода
+    cout << "\nVertex reordering (traversal time / LLC read misses):\n";
+    {
+        CompactGraph g = generateCompactGraph(GraphFamily::ErdosRenyi, 1 << 20, 4000000, false, 16, 16, gen());
+        CacheMissCounter counter;
+        if (!counter.available()) cout << "perf_event is not available, LLC misses are reported as -1\n";
+
+        // Полный BFS и полный DFS из вершины start, возвращает время и промахи кэша
+        auto measure = [&counter](CompactGraph& graph, int start, const char* name) {
+            vector<int> path;
+            counter.start();
+            auto bfs_start = chrono::high_resolution_clock::now();
+            bfs(graph, start, start, path);
+            auto bfs_end = chrono::high_resolution_clock::now();
+            long long bfs_misses = counter.stop();
+
+            vector<char> visited(graph.getVertices(), 0);
+            counter.start();
+            auto dfs_start = chrono::high_resolution_clock::now();
+            for (int root = 0; root < graph.getVertices(); ++root) {
+                if (!visited[root]) dfsTraverse(graph, root, visited, [](int, int) {}, [](int, int, int) {}, [](int, int) {});
+            }
+            auto dfs_end = chrono::high_resolution_clock::now();
+            long long dfs_misses = counter.stop();
+
+            cout << setw(12) << name << ": BFS " << chrono::duration<double>(bfs_end - bfs_start).count() << "s / " << bfs_misses
+                 << ", DFS " << chrono::duration<double>(dfs_end - dfs_start).count() << "s / " << dfs_misses << "\n";
+        };
+
+        int start = 0;
+        measure(g, start, "Original");
+        const char* ordering_names[] = {"BFS order", "RCM", "Degree sort"};
+        VertexOrdering orderings[] = {VertexOrdering::BfsOrder, VertexOrdering::ReverseCuthillMcKee, VertexOrdering::DegreeSort};
+        for (int k = 0; k < 3; ++k) {
+            auto relabel_start = chrono::high_resolution_clock::now();
+            VertexRelabeling relabeling = computeVertexOrdering(g, orderings[k]);
+            CompactGraph reordered = relabelGraph(g, relabeling);
+            auto relabel_end = chrono::high_resolution_clock::now();
+            measure(reordered, relabeling.old_to_new[start], ordering_names[k]);
+            cout << setw(12) << "" << "  (relabeling took " << chrono::duration<double>(relabel_end - relabel_start).count() << "s)\n";
+        }
+    }
+
+    // Сравнение пакетного BFS с многократным запуском обычного BFS
+    {
+        int v = 100000;
+        long long e = 300000;
+        CompactGraph g = generateCompactGraph(GraphFamily::ErdosRenyi, v, e, true, max_out_edges, max_in_edges, gen());
+        uniform_int_distribution<> vertex_choice(0, v - 1);
+        vector<int> sources(64);
+        for (int& s : sources) s = vertex_choice(gen);
+
+        auto single_start = chrono::high_resolution_clock::now();
+        for (int s : sources) {
+            vector<int> path;
+            bfs(g, s, s, path); // end == start: выполняется полный обход из s
+        }
+        auto single_end = chrono::high_resolution_clock::now();
+        double single_time = chrono::duration<double>(single_end - single_start).count();
+
+        auto batch_start = chrono::high_resolution_clock::now();
+        vector<vector<int>> dist = multiSourceBfs(g, sources);
+        auto batch_end = chrono::high_resolution_clock::now();
+        double batch_time = chrono::duration<double>(batch_end - batch_start).count();
+
+        // Проверяем, что пакетный BFS даёт те же расстояния, что и обычный
+        int mismatches = 0;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            int target = vertex_choice(gen);
+            vector<int> path;
+            if (bfs(g, sources[i], target, path) != dist[i][target]) mismatches++;
+        }
+
+        cout << "\nMulti-source BFS (V=" << v << ", E=" << g.getEdgeCount() << ", sources=" << sources.size() << "):\n";
+        cout << "Repeated BFS time: " << single_time << "s\n";
+        cout << "Batched BFS time: " << batch_time << "s\n";
+        cout << "Mismatches: " << mismatches << "\n";
+    }
+
     return 0;
 }
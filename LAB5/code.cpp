@@ -7,124 +7,1640 @@
 #include <chrono>
 #include <climits>
 #include <fstream>
+#include <thread>
+#include <limits>
+#include <new>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <memory>
+#include <cmath>
+#include <stdexcept>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
-// Класс для работы с графом, где есть вершины и ребра с весами
-class WeightedGraph {
+// Способ хранения графа
+enum class GraphStorage {
+    AdjacencyMatrix, // Матрица весов V x V: подходит для небольших и плотных графов
+    AdjacencyList    // Списки (сосед, вес) для каждой вершины: подходит для больших разреженных графов
+};
+
+// Алгоритм построения минимального остовного дерева, выбирается во время выполнения
+enum class MstAlgorithm {
+    PrimDense,           // Классический Прим O(V^2): линейный поиск минимума по key[]
+    PrimLazyBinaryHeap,  // Прим с бинарной кучей без decrease-key: устаревшие записи пропускаются при извлечении
+    PrimIndexedDaryHeap, // Прим с индексированной 4-арной кучей и decrease-key
+    PrimPairingHeap,     // Прим со спаривающейся кучей, decrease-key за амортизированное O(1)
+    Kruskal,             // Краскал: параллельная сортировка рёбер + система непересекающихся множеств
+    Boruvka              // Борувка: раунды стягивания компонент, поиск минимальных рёбер идёт параллельно
+};
+
+// Названия алгоритмов для вывода и CSV
+const char* mst_algorithm_name(MstAlgorithm algorithm) {
+    switch (algorithm) {
+        case MstAlgorithm::PrimDense: return "PrimDense";
+        case MstAlgorithm::PrimLazyBinaryHeap: return "PrimLazyBinaryHeap";
+        case MstAlgorithm::PrimIndexedDaryHeap: return "PrimIndexedDaryHeap";
+        case MstAlgorithm::PrimPairingHeap: return "PrimPairingHeap";
+        case MstAlgorithm::Kruskal: return "Kruskal";
+        case MstAlgorithm::Boruvka: return "Boruvka";
+    }
+    return "Unknown";
+}
+
+const MstAlgorithm all_mst_algorithms[] = {MstAlgorithm::PrimDense, MstAlgorithm::PrimLazyBinaryHeap,
+                                           MstAlgorithm::PrimIndexedDaryHeap, MstAlgorithm::PrimPairingHeap,
+                                           MstAlgorithm::Kruskal, MstAlgorithm::Boruvka};
+
+// Ребро неориентированного графа
+struct Edge {
+    int u, v, weight;
+};
+
+// Система непересекающихся множеств со сжатием путей и объединением по рангу
+class DisjointSet {
 private:
-    int num_vertices; // Сколько всего вершин в графе
-    int min_edges;    // Минимум ребер, которые должны выходить из каждой вершины
-    vector<vector<int>> adj_matrix; // Матрица, где хранятся веса ребер между вершинами
-    mt19937 rng;      // Генератор случайных чисел для случайного графа
+    vector<int> parent; // Родитель элемента (корень указывает сам на себя)
+    vector<unsigned char> rank; // Верхняя оценка высоты дерева множества
 
-    // Делает граф связным: если какие-то вершины не соединены, добавляет ребра
-    void ensure_connectivity() {
+public:
+    explicit DisjointSet(int n) : parent(n), rank(n, 0) {
+        for (int i = 0; i < n; ++i) parent[i] = i;
+    }
+
+    // Находит представителя множества и подвешивает весь путь прямо к нему
+    int find(int x) {
+        int root = x;
+        while (parent[root] != root) root = parent[root];
+        while (parent[x] != root) {
+            int next = parent[x];
+            parent[x] = root;
+            x = next;
+        }
+        return root;
+    }
+
+    // Объединяет множества a и b; возвращает false, если они уже совпадают
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+        return true;
+    }
+};
+
+// Количество рабочих потоков для параллельных частей
+int worker_count() {
+    unsigned int hw = thread::hardware_concurrency();
+    return hw == 0 ? 1 : (int)hw;
+}
+
+// Делит диапазон [0, n) на равные куски и обрабатывает каждый в своём потоке: f(begin, end, номер потока)
+template <typename Func>
+void parallel_for_chunks(size_t n, int threads, Func f) {
+    if (threads <= 1 || n < 4096) { // Для маленьких объёмов потоки только мешают
+        f(size_t(0), n, 0);
+        return;
+    }
+    vector<thread> pool;
+    size_t chunk = (n + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        size_t begin = min(n, t * chunk), end = min(n, begin + chunk);
+        pool.emplace_back(f, begin, end, t);
+    }
+    for (auto& th : pool) th.join();
+}
+
+// Параллельная сортировка рёбер по весу: куски сортируются в отдельных потоках, затем попарно сливаются
+void parallel_sort_edges(vector<Edge>& edges) {
+    auto by_weight = [](const Edge& a, const Edge& b) { return a.weight < b.weight; };
+    int threads = worker_count();
+    if (threads <= 1 || edges.size() < 4096) {
+        sort(edges.begin(), edges.end(), by_weight);
+        return;
+    }
+    size_t chunk = (edges.size() + threads - 1) / threads;
+    vector<size_t> bounds; // Границы отсортированных кусков
+    for (size_t b = 0; b < edges.size(); b += chunk) bounds.push_back(b);
+    bounds.push_back(edges.size());
+
+    vector<thread> pool;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        pool.emplace_back([&, i]() { sort(edges.begin() + bounds[i], edges.begin() + bounds[i + 1], by_weight); });
+    }
+    for (auto& th : pool) th.join();
+
+    // Сливаем соседние куски, пока не останется один
+    while (bounds.size() > 2) {
+        vector<size_t> merged;
+        pool.clear();
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+            if (i + 2 < bounds.size()) {
+                size_t lo = bounds[i], mid = bounds[i + 1], hi = bounds[i + 2];
+                pool.emplace_back([&edges, lo, mid, hi, by_weight]() {
+                    inplace_merge(edges.begin() + lo, edges.begin() + mid, edges.begin() + hi, by_weight);
+                });
+            }
+        }
+        merged.push_back(bounds.back());
+        for (auto& th : pool) th.join();
+        bounds = merged;
+    }
+}
+
+// Генератор случайных чисел на счётчике: i-е число потока stream определяется только
+// (seed, stream, i), поэтому потоки можно раздавать разным нитям без общей синхронизации
+// и результат не зависит от числа нитей (хеширование как в SplitMix64)
+class CounterRng {
+private:
+    uint64_t key;         // Ключ потока, полученный из seed и номера потока
+    uint64_t counter = 0; // Номер следующего числа в потоке
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    CounterRng(uint64_t seed, uint64_t stream) : key(mix(seed ^ mix(stream + 0x9e3779b97f4a7c15ULL))) {}
+
+    uint64_t next() { return mix(key + 0x9e3779b97f4a7c15ULL * ++counter); }
+
+    // Равномерное целое из [lo, hi] (умножение со сдвигом, смещение пренебрежимо мало)
+    int uniform(int lo, int hi) {
+        uint64_t range = uint64_t(hi - lo) + 1;
+        return lo + int(((next() >> 32) * range) >> 32);
+    }
+};
+
+// Индексированная d-арная куча вершин по ключу с операцией уменьшения ключа
+class IndexedDaryHeap {
+private:
+    static const int D = 4;  // Арность кучи: 4 потомка лучше используют кэш, чем 2
+    vector<int> heap;        // Вершины в порядке кучи
+    vector<int> pos;         // Позиция вершины в heap (-1, если её там нет)
+    vector<int> key;         // Текущий ключ вершины
+
+    void sift_up(int i) {
+        int v = heap[i];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (key[heap[p]] <= key[v]) break;
+            heap[i] = heap[p];
+            pos[heap[i]] = i;
+            i = p;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+
+    void sift_down(int i) {
+        int v = heap[i];
+        int n = heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first; // Ищем потомка с минимальным ключом
+            for (int c = first + 1; c < min(first + D, n); ++c) {
+                if (key[heap[c]] < key[heap[best]]) best = c;
+            }
+            if (key[heap[best]] >= key[v]) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+
+public:
+    explicit IndexedDaryHeap(int n) : pos(n, -1), key(n, INT_MAX) {}
+
+    [[nodiscard]] bool empty() const { return heap.empty(); }
+    [[nodiscard]] bool contains(int v) const { return pos[v] != -1; }
+    [[nodiscard]] int get_key(int v) const { return key[v]; }
+
+    // Добавляет вершину или уменьшает её ключ
+    void push_or_decrease(int v, int k) {
+        if (pos[v] == -1) {
+            key[v] = k;
+            heap.push_back(v);
+            sift_up(heap.size() - 1);
+        } else if (k < key[v]) {
+            key[v] = k;
+            sift_up(pos[v]);
+        }
+    }
+
+    // Извлекает вершину с минимальным ключом
+    int pop_min() {
+        int top = heap[0];
+        pos[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last] = 0;
+            sift_down(0);
+        }
+        return top;
+    }
+};
+
+// Спаривающаяся куча (pairing heap) на массивах: узлом кучи служит сама вершина
+class PairingHeap {
+private:
+    vector<int> key;     // Ключ вершины
+    vector<int> child;   // Самый левый потомок
+    vector<int> sibling; // Правый брат
+    vector<int> prev;    // Левый брат или родитель, если узел — самый левый потомок
+    vector<char> in_heap;
+    int root = -1;
+
+    // Сливает две кучи, возвращает новый корень
+    int meld(int a, int b) {
+        if (a == -1) return b;
+        if (b == -1) return a;
+        if (key[b] < key[a]) swap(a, b);
+        // b становится самым левым потомком a
+        sibling[b] = child[a];
+        if (child[a] != -1) prev[child[a]] = b;
+        prev[b] = a;
+        child[a] = b;
+        sibling[a] = -1;
+        prev[a] = -1;
+        return a;
+    }
+
+    // Двухпроходное слияние списка братьев, начиная с first
+    int merge_pairs(int first) {
+        vector<int>& pairs = merge_buffer;
+        pairs.clear();
+        while (first != -1) {
+            int a = first;
+            int b = sibling[a];
+            first = b == -1 ? -1 : sibling[b];
+            sibling[a] = -1;
+            prev[a] = -1;
+            if (b != -1) {
+                sibling[b] = -1;
+                prev[b] = -1;
+            }
+            pairs.push_back(meld(a, b)); // Первый проход: слева направо попарно
+        }
+        int result = -1;
+        for (int i = (int)pairs.size() - 1; i >= 0; --i) result = meld(pairs[i], result); // Второй проход: справа налево
+        return result;
+    }
+
+    vector<int> merge_buffer; // Буфер для merge_pairs, чтобы не выделять память при каждом извлечении
+
+public:
+    explicit PairingHeap(int n) : key(n, INT_MAX), child(n, -1), sibling(n, -1), prev(n, -1), in_heap(n, 0) {}
+
+    [[nodiscard]] bool empty() const { return root == -1; }
+    [[nodiscard]] bool contains(int v) const { return in_heap[v]; }
+    [[nodiscard]] int get_key(int v) const { return key[v]; }
+
+    // Добавляет вершину или уменьшает её ключ
+    void push_or_decrease(int v, int k) {
+        if (!in_heap[v]) {
+            in_heap[v] = 1;
+            key[v] = k;
+            child[v] = sibling[v] = prev[v] = -1;
+            root = meld(root, v);
+            return;
+        }
+        if (k >= key[v]) return;
+        key[v] = k;
+        if (v == root) return;
+        // Вырезаем поддерево v и сливаем его с корнем
+        if (child[prev[v]] == v) child[prev[v]] = sibling[v];
+        else sibling[prev[v]] = sibling[v];
+        if (sibling[v] != -1) prev[sibling[v]] = prev[v];
+        sibling[v] = prev[v] = -1;
+        root = meld(root, v);
+    }
+
+    // Извлекает вершину с минимальным ключом
+    int pop_min() {
+        int top = root;
+        in_heap[top] = 0;
+        root = merge_pairs(child[top]);
+        child[top] = -1;
+        return top;
+    }
+};
+
+// Уровень векторных инструкций для ядра плотного Прима
+enum class SimdLevel {
+    Scalar, // Обычный цикл (работает везде)
+    Avx2,   // 8 ключей за инструкцию
+    Avx512  // 16 ключей за инструкцию, маски вместо blend
+};
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define LAB5_X86_SIMD 1
+#endif
+
+// Определяет лучший доступный набор инструкций во время выполнения
+SimdLevel detect_simd_level() {
+#ifdef LAB5_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::Avx2: return "AVX2";
+        case SimdLevel::Avx512: return "AVX-512";
+    }
+    return "Unknown";
+}
+
+// Набор инструкций, которым пользуется плотный Прим (можно переопределить для сравнения)
+SimdLevel prim_simd_level = detect_simd_level();
+
+// Ключи вершин в плотном Приме: вершина уже в MST или ещё не достигнута
+const int KEY_IN_MST = INT_MAX;
+const int KEY_UNREACHED = INT_MAX - 1;
+
+// Ядро плотного Прима для одной строки матрицы: для всех v с ребром (u, v), ещё не в MST,
+// выполняет key[v] = min(key[v], w) и запоминает родителя, и тут же ищет вершину с минимальным
+// ключом вне MST (при равенстве — с меньшим номером). Возвращает её номер или -1.
+// Вершины в MST помечены key = KEY_IN_MST, поэтому отдельный массив in_mst не нужен.
+template <typename Weight>
+int prim_row_scalar(const Weight* row, int begin, int n, int u, int* key, int* parent, int& best_key) {
+    int best = -1;
+    for (int v = begin; v < n; ++v) {
+        int weight = row[v];
+        bool better = (weight > 0) & (weight < key[v]) & (key[v] != KEY_IN_MST);
+        key[v] = better ? weight : key[v];
+        parent[v] = better ? u : parent[v];
+        if (key[v] < best_key) {
+            best_key = key[v];
+            best = v;
+        }
+    }
+    return best;
+}
+
+#ifdef LAB5_X86_SIMD
+// Загрузка 8 весов с расширением до int32
+template <typename Weight>
+__attribute__((target("avx2"))) inline __m256i load_weights_avx2(const Weight* p) {
+    if constexpr (sizeof(Weight) == 1) {
+        __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return is_signed<Weight>::value ? _mm256_cvtepi8_epi32(raw) : _mm256_cvtepu8_epi32(raw);
+    } else if constexpr (sizeof(Weight) == 2) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return is_signed<Weight>::value ? _mm256_cvtepi16_epi32(raw) : _mm256_cvtepu16_epi32(raw);
+    } else {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+}
+
+template <typename Weight>
+__attribute__((target("avx2"))) int prim_row_avx2(const Weight* row, int n, int u, int* key, int* parent) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i in_mst = _mm256_set1_epi32(KEY_IN_MST);
+    const __m256i parent_u = _mm256_set1_epi32(u);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i best_key = _mm256_set1_epi32(INT_MAX);
+    __m256i best_index = _mm256_set1_epi32(-1);
+
+    int v = 0;
+    for (; v + 8 <= n; v += 8) {
+        __m256i w = load_weights_avx2(row + v);
+        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + v));
+        // Маска релаксации: есть ребро, оно легче текущего ключа и вершина не в MST
+        __m256i mask = _mm256_and_si256(_mm256_cmpgt_epi32(w, zero), _mm256_cmpgt_epi32(k, w));
+        mask = _mm256_andnot_si256(_mm256_cmpeq_epi32(k, in_mst), mask);
+        k = _mm256_blendv_epi8(k, w, mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(key + v), k);
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(parent + v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(parent + v), _mm256_blendv_epi8(p, parent_u, mask));
+
+        // Поиск минимума по полосам: строгое сравнение сохраняет меньший номер при равенстве
+        __m256i less = _mm256_cmpgt_epi32(best_key, k);
+        best_key = _mm256_blendv_epi8(best_key, k, less);
+        best_index = _mm256_blendv_epi8(best_index, index, less);
+        index = _mm256_add_epi32(index, step);
+    }
+
+    // Сводим 8 полос в один результат
+    alignas(32) int lane_key[8], lane_index[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_key), best_key);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_index), best_index);
+    int best = -1, best_value = INT_MAX;
+    for (int lane = 0; lane < 8; ++lane) {
+        if (lane_index[lane] == -1) continue;
+        if (lane_key[lane] < best_value || (lane_key[lane] == best_value && lane_index[lane] < best)) {
+            best_value = lane_key[lane];
+            best = lane_index[lane];
+        }
+    }
+    int tail = prim_row_scalar(row, v, n, u, key, parent, best_value); // Оставшиеся < 8 вершин
+    return tail != -1 ? tail : best;
+}
+
+// Загрузка 16 весов с расширением до int32.
+// Используются maskz-формы с полной маской: обычные _mm512_cvt* в GCC 12 берут
+// _mm512_undefined_epi32() как источник и дают ложные предупреждения -Wuninitialized
+template <typename Weight>
+__attribute__((target("avx512f"))) inline __m512i load_weights_avx512(const Weight* p) {
+    const __mmask16 all = 0xFFFF;
+    if constexpr (sizeof(Weight) == 1) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return is_signed<Weight>::value ? _mm512_maskz_cvtepi8_epi32(all, raw) : _mm512_maskz_cvtepu8_epi32(all, raw);
+    } else if constexpr (sizeof(Weight) == 2) {
+        __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        return is_signed<Weight>::value ? _mm512_maskz_cvtepi16_epi32(all, raw) : _mm512_maskz_cvtepu16_epi32(all, raw);
+    } else {
+        return _mm512_loadu_si512(p);
+    }
+}
+
+template <typename Weight>
+__attribute__((target("avx512f"))) int prim_row_avx512(const Weight* row, int n, int u, int* key, int* parent) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i in_mst = _mm512_set1_epi32(KEY_IN_MST);
+    const __m512i parent_u = _mm512_set1_epi32(u);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i best_key = _mm512_set1_epi32(INT_MAX);
+    __m512i best_index = _mm512_set1_epi32(INT_MAX);
+
+    int v = 0;
+    for (; v + 16 <= n; v += 16) {
+        __m512i w = load_weights_avx512(row + v);
+        __m512i k = _mm512_loadu_si512(key + v);
+        __mmask16 mask = _mm512_cmpgt_epi32_mask(w, zero) & _mm512_cmplt_epi32_mask(w, k)
+                         & _mm512_cmpneq_epi32_mask(k, in_mst);
+        k = _mm512_mask_mov_epi32(k, mask, w);
+        _mm512_storeu_si512(key + v, k);
+        _mm512_mask_storeu_epi32(parent + v, mask, parent_u); // Родитель пишется только в изменённые полосы
+
+        __mmask16 less = _mm512_cmplt_epi32_mask(k, best_key);
+        best_key = _mm512_mask_mov_epi32(best_key, less, k);
+        best_index = _mm512_mask_mov_epi32(best_index, less, index);
+        index = _mm512_add_epi32(index, step);
+    }
+
+    // Сводим 16 полос в один результат, как в AVX2-версии
+    // (_mm512_reduce_min_epi32 в GCC 12 даёт ложные предупреждения -Wuninitialized)
+    alignas(64) int lane_key[16], lane_index[16];
+    _mm512_store_si512(lane_key, best_key);
+    _mm512_store_si512(lane_index, best_index);
+    int best = -1, best_value = INT_MAX;
+    for (int lane = 0; lane < 16; ++lane) {
+        if (lane_index[lane] == INT_MAX) continue;
+        if (lane_key[lane] < best_value || (lane_key[lane] == best_value && lane_index[lane] < best)) {
+            best_value = lane_key[lane];
+            best = lane_index[lane];
+        }
+    }
+    int tail = prim_row_scalar(row, v, n, u, key, parent, best_value);
+    return tail != -1 ? tail : best;
+}
+#endif
+
+// Выбирает реализацию ядра по уровню инструкций
+template <typename Weight>
+int prim_row_update(SimdLevel level, const Weight* row, int n, int u, int* key, int* parent) {
+#ifdef LAB5_X86_SIMD
+    if (level == SimdLevel::Avx512) return prim_row_avx512(row, n, u, key, parent);
+    if (level == SimdLevel::Avx2) return prim_row_avx2(row, n, u, key, parent);
+#endif
+    int best_key = INT_MAX;
+    return prim_row_scalar(row, 0, n, u, key, parent, best_key);
+}
+
+// Дерево связей-разрезов (link-cut tree) на splay-деревьях. Поддерживает лес с операциями
+// link / cut / connected и запросом максимума на пути за амортизированное O(log n).
+// Рёбра остовного леса хранятся как отдельные узлы с весом, вершины графа имеют вес INT_MIN,
+// поэтому максимум на пути — это самое тяжёлое ребро пути.
+class LinkCutTree {
+private:
+    vector<int> child[2]; // Левый и правый потомок в splay-дереве
+    vector<int> parent;   // Родитель в splay-дереве или путевой указатель
+    vector<char> flipped; // Отложенный разворот поддерева
+    vector<int> value;    // Вес узла
+    vector<int> best;     // Узел с максимальным весом в splay-поддереве
+
+    [[nodiscard]] bool is_splay_root(int x) const {
+        int p = parent[x];
+        return p == -1 || (child[0][p] != x && child[1][p] != x);
+    }
+
+    void pull(int x) {
+        best[x] = x;
+        for (int side = 0; side < 2; ++side) {
+            int c = child[side][x];
+            if (c != -1 && value[best[c]] > value[best[x]]) best[x] = best[c];
+        }
+    }
+
+    void toggle(int x) {
+        if (x == -1) return;
+        swap(child[0][x], child[1][x]);
+        flipped[x] ^= 1;
+    }
+
+    void push(int x) {
+        if (!flipped[x]) return;
+        toggle(child[0][x]);
+        toggle(child[1][x]);
+        flipped[x] = 0;
+    }
+
+    void rotate(int x) {
+        int y = parent[x], z = parent[y];
+        int dir = child[1][y] == x;
+        if (!is_splay_root(y)) child[child[1][z] == y][z] = x;
+        parent[x] = z;
+        child[dir][y] = child[!dir][x];
+        if (child[dir][y] != -1) parent[child[dir][y]] = y;
+        child[!dir][x] = y;
+        parent[y] = x;
+        pull(y);
+        pull(x);
+    }
+
+    void splay(int x) {
+        // Сначала проталкиваем отложенные развороты сверху вниз
+        path_buffer.clear();
+        for (int y = x;; y = parent[y]) {
+            path_buffer.push_back(y);
+            if (is_splay_root(y)) break;
+        }
+        for (int i = (int)path_buffer.size() - 1; i >= 0; --i) push(path_buffer[i]);
+
+        while (!is_splay_root(x)) {
+            int y = parent[x];
+            if (!is_splay_root(y)) {
+                int z = parent[y];
+                rotate((child[0][y] == x) == (child[0][z] == y) ? y : x);
+            }
+            rotate(x);
+        }
+    }
+
+    // Делает путь от корня дерева до x предпочтительным; x становится корнем своего splay-дерева
+    void access(int x) {
+        int last = -1;
+        for (int y = x; y != -1; y = parent[y]) {
+            splay(y);
+            child[1][y] = last;
+            pull(y);
+            last = y;
+        }
+        splay(x);
+    }
+
+    void make_root(int x) {
+        access(x);
+        toggle(x);
+    }
+
+    int find_root(int x) {
+        access(x);
         while (true) {
-            vector<bool> visited(num_vertices, false); // Отмечаем, какие вершины мы уже видели
-            queue<int> q; // Очередь для обхода вершин
-            q.push(0);    // Начинаем с вершины 0
-            visited[0] = true;
-
-            // Обходим граф, чтобы найти все вершины, до которых можно дойти
-            while (!q.empty()) {
-                int vertex = q.front(); // Берем вершину из очереди
-                q.pop();
-                for (int i = 0; i < num_vertices; ++i) {
-                    if (adj_matrix[vertex][i] > 0 && !visited[i]) { // Если есть ребро и вершина еще не посещена
-                        visited[i] = true; // Отмечаем вершину как посещенную
-                        q.push(i);         // Добавляем ее в очередь
+            push(x);
+            if (child[0][x] == -1) break;
+            x = child[0][x];
+        }
+        splay(x);
+        return x;
+    }
+
+    vector<int> path_buffer; // Буфер для splay, чтобы не выделять память при каждом вызове
+
+public:
+    // Добавляет изолированный узел с заданным весом, возвращает его номер
+    int add_node(int weight) {
+        child[0].push_back(-1);
+        child[1].push_back(-1);
+        parent.push_back(-1);
+        flipped.push_back(0);
+        value.push_back(weight);
+        best.push_back(value.size() - 1);
+        return value.size() - 1;
+    }
+
+    // Повторно использует изолированный узел с новым весом
+    void reset_node(int x, int weight) {
+        child[0][x] = child[1][x] = parent[x] = -1;
+        flipped[x] = 0;
+        value[x] = weight;
+        best[x] = x;
+    }
+
+    [[nodiscard]] int weight(int x) const { return value[x]; }
+
+    bool connected(int x, int y) { return x == y || find_root(x) == find_root(y); }
+
+    // Соединяет деревья узлов x и y ребром x - y
+    void link(int x, int y) {
+        make_root(x);
+        parent[x] = y;
+    }
+
+    // Удаляет ребро x - y (оно должно существовать)
+    void cut(int x, int y) {
+        make_root(x);
+        access(y);
+        child[0][y] = -1; // После access(y) узел x — единственный левый потомок y
+        parent[x] = -1;
+        pull(y);
+    }
+
+    // Узел с максимальным весом на пути x - y
+    int path_max(int x, int y) {
+        make_root(x);
+        access(y);
+        return best[y];
+    }
+};
+
+// Поддерживаемое минимальное остовное дерево (лес) для графа, рёбра которого меняются.
+// Вставка и уменьшение веса используют свойство цикла: новое ребро вытесняет самое тяжёлое
+// ребро на пути между его концами (запрос к LinkCutTree). Удаление и увеличение веса ребра
+// дерева используют свойство разреза: ребро вырезается, меньшая из двух половин находится
+// параллельным обходом дерева с обоих концов, и среди рёбер графа, выходящих из неё,
+// выбирается самое лёгкое. Граф к моменту вызова уже должен быть изменён.
+class DynamicMst {
+private:
+    int num_vertices;
+    LinkCutTree forest;                      // Узлы 0..V-1 — вершины, дальше — рёбра дерева
+    unordered_map<uint64_t, int> edge_node;  // Ребро дерева (u < v) -> его узел в forest
+    vector<pair<int, int>> node_edge;        // Узел ребра -> концы ребра (индекс со сдвигом на V)
+    vector<int> free_nodes;                  // Освободившиеся узлы рёбер для повторного использования
+    vector<vector<int>> tree_adj;            // Соседи в остовном лесу (для поиска меньшей половины)
+    long long total_weight = 0;              // Вес леса
+    vector<int> side_mark;                   // Метка посещения в поиске половины (сравнивается со stamp)
+    int stamp = 0;
+
+    static uint64_t edge_key(int u, int v) {
+        if (u > v) swap(u, v);
+        return (uint64_t(uint32_t(u)) << 32) | uint32_t(v);
+    }
+
+    static void erase_value(vector<int>& list, int value) {
+        auto it = find(list.begin(), list.end(), value);
+        *it = list.back();
+        list.pop_back();
+    }
+
+    void add_tree_edge(int u, int v, int weight) {
+        int node;
+        if (free_nodes.empty()) {
+            node = forest.add_node(weight);
+            node_edge.emplace_back(u, v);
+        } else {
+            node = free_nodes.back();
+            free_nodes.pop_back();
+            forest.reset_node(node, weight);
+            node_edge[node - num_vertices] = {u, v};
+        }
+        forest.link(u, node);
+        forest.link(node, v);
+        edge_node[edge_key(u, v)] = node;
+        tree_adj[u].push_back(v);
+        tree_adj[v].push_back(u);
+        total_weight += weight;
+    }
+
+    void remove_tree_edge(int node) {
+        auto [u, v] = node_edge[node - num_vertices];
+        forest.cut(u, node);
+        forest.cut(node, v);
+        edge_node.erase(edge_key(u, v));
+        erase_value(tree_adj[u], v);
+        erase_value(tree_adj[v], u);
+        total_weight -= forest.weight(node);
+        free_nodes.push_back(node);
+    }
+
+    // После разреза дерева между a и b ищет самое лёгкое ребро графа, соединяющее половины
+    template <typename ForEachNeighbor>
+    void reconnect(int a, int b, ForEachNeighbor for_each_neighbor) {
+        // Обходим обе половины по очереди, пока одна не закончится: она и есть меньшая
+        stamp += 2;
+        int mark[2] = {stamp - 1, stamp};
+        vector<int> side[2] = {{a}, {b}};
+        size_t head[2] = {0, 0};
+        side_mark[a] = mark[0];
+        side_mark[b] = mark[1];
+        int smaller = -1;
+        while (smaller == -1) {
+            for (int s = 0; s < 2 && smaller == -1; ++s) {
+                if (head[s] == side[s].size()) {
+                    smaller = s;
+                    break;
+                }
+                int x = side[s][head[s]++];
+                for (int y : tree_adj[x]) {
+                    if (side_mark[y] != mark[s]) {
+                        side_mark[y] = mark[s];
+                        side[s].push_back(y);
                     }
                 }
             }
+        }
 
-            // Проверяем, дошли ли мы до всех вершин
-            bool all_reachable = true;
-            for (int i = 0; i < num_vertices; ++i) {
-                if (!visited[i]) { // Если вершина i осталась недостижимой
-                    all_reachable = false;
-                    vector<int> reachable; // Собираем вершины, до которых дошли
-                    for (int j = 0; j < num_vertices; ++j) {
-                        if (visited[j]) reachable.push_back(j);
-                    }
-                    // Выбираем случайную достижимую вершину и соединяем с недостижимой
-                    uniform_int_distribution<int> dist(0, reachable.size() - 1);
-                    int connect_to = reachable[dist(rng)];
-                    uniform_int_distribution<int> weight_dist(1, 20);
-                    int weight = weight_dist(rng); // Вес ребра — случайное число от 1 до 20
-                    adj_matrix[connect_to][i] = weight;
-                    adj_matrix[i][connect_to] = weight; // Добавляем ребро в обе стороны (граф неориентированный)
-                    break; // Повторяем проверку с начала
+        // Самое лёгкое ребро из меньшей половины наружу
+        int best_weight = INT_MAX, best_u = -1, best_v = -1;
+        for (int x : side[smaller]) {
+            for_each_neighbor(x, [&](int y, int weight) {
+                if (side_mark[y] != mark[smaller] && weight < best_weight) {
+                    best_weight = weight;
+                    best_u = x;
+                    best_v = y;
                 }
+            });
+        }
+        if (best_u != -1) add_tree_edge(best_u, best_v, best_weight); // Иначе граф распался на две компоненты
+    }
+
+public:
+    // Строит структуру по готовому остовному лесу
+    DynamicMst(int vertices, const vector<Edge>& mst_edges)
+            : num_vertices(vertices), tree_adj(vertices), side_mark(vertices, 0) {
+        for (int v = 0; v < vertices; ++v) forest.add_node(INT_MIN);
+        for (const Edge& e : mst_edges) add_tree_edge(e.u, e.v, e.weight);
+    }
+
+    [[nodiscard]] long long get_total_weight() const { return total_weight; }
+    [[nodiscard]] bool is_tree_edge(int u, int v) const { return edge_node.count(edge_key(u, v)) != 0; }
+
+    // Рёбра текущего остовного леса
+    [[nodiscard]] vector<pair<int, int>> edges() const {
+        vector<pair<int, int>> result;
+        result.reserve(edge_node.size());
+        for (const auto& [key, node] : edge_node) result.push_back(node_edge[node - num_vertices]);
+        return result;
+    }
+
+    // В граф добавлено ребро (u, v) с весом weight
+    void on_insert(int u, int v, int weight) {
+        if (!forest.connected(u, v)) {
+            add_tree_edge(u, v, weight);
+            return;
+        }
+        int heaviest = forest.path_max(u, v); // Самое тяжёлое ребро цикла, который замкнёт (u, v)
+        if (forest.weight(heaviest) <= weight) return;
+        remove_tree_edge(heaviest);
+        add_tree_edge(u, v, weight);
+    }
+
+    // Из графа удалено ребро (u, v)
+    template <typename ForEachNeighbor>
+    void on_remove(int u, int v, ForEachNeighbor for_each_neighbor) {
+        auto it = edge_node.find(edge_key(u, v));
+        if (it == edge_node.end()) return; // Ребро не входило в дерево — дерево не меняется
+        remove_tree_edge(it->second);
+        reconnect(u, v, for_each_neighbor);
+    }
+
+    // У ребра (u, v) изменился вес с old_weight на new_weight
+    template <typename ForEachNeighbor>
+    void on_reweight(int u, int v, int old_weight, int new_weight, ForEachNeighbor for_each_neighbor) {
+        auto it = edge_node.find(edge_key(u, v));
+        if (it == edge_node.end()) {
+            if (new_weight < old_weight) on_insert(u, v, new_weight); // Подешевевшее ребро может войти в дерево
+            return;
+        }
+        int node = it->second;
+        remove_tree_edge(node);
+        if (new_weight < old_weight) add_tree_edge(u, v, new_weight); // Ребро дерева подешевело — оно остаётся
+        else reconnect(u, v, for_each_neighbor); // Подорожало — ищем замену (им может оказаться оно само)
+    }
+};
+
+// Запросы "самое тяжёлое ребро на пути в минимальном остовном лесу" за O(1).
+// Рёбра леса добавляются в порядке Краскала, и у каждой компоненты хранится список её вершин:
+// при объединении списки склеиваются, а на стыке запоминается вес соединившего их ребра.
+// В итоговом порядке вершин (это порядок листьев дерева Краскала) ответ для u и v — максимум
+// весов стыков между их позициями; он берётся из разреженной таблицы за O(1).
+class BottleneckOracle {
+private:
+    static constexpr int NO_PATH = INT_MAX; // Стык между разными деревьями леса
+    vector<int> position;               // Позиция вершины в порядке листьев
+    vector<vector<int>> sparse;         // sparse[k][i] — максимум стыков i .. i + 2^k - 1
+    vector<int> log2_floor;             // log2_floor[len] = floor(log2(len))
+
+public:
+    BottleneckOracle() = default;
+
+    // forest — рёбра минимального остовного леса, отсортированные по весу
+    BottleneckOracle(int n, const vector<Edge>& forest) : position(n) {
+        DisjointSet components(n);
+        vector<int> head(n), tail(n), next(n, -1), gap(n, NO_PATH); // gap[x] — стык между x и next[x]
+        for (int i = 0; i < n; ++i) head[i] = tail[i] = i;
+        for (const Edge& e : forest) {
+            int a = components.find(e.u), b = components.find(e.v);
+            int first_head = head[a], first_tail = tail[a], second_head = head[b], second_tail = tail[b];
+            components.unite(a, b);
+            int root = components.find(a);
+            next[first_tail] = second_head;
+            gap[first_tail] = e.weight;
+            head[root] = first_head;
+            tail[root] = second_tail;
+        }
+
+        // Склеиваем деревья леса в одну последовательность, стыки между ними — NO_PATH
+        vector<int> order;
+        order.reserve(n);
+        for (int r = 0; r < n; ++r) {
+            if (components.find(r) != r) continue;
+            for (int x = head[r]; x != -1; x = next[x]) order.push_back(x);
+        }
+        int m = max(0, n - 1); // Число стыков
+        vector<int> gaps(m);
+        for (int i = 0; i < n; ++i) {
+            position[order[i]] = i;
+            if (i < m) gaps[i] = gap[order[i]]; // Для последней вершины дерева gap остался NO_PATH
+        }
+
+        log2_floor.assign(m + 1, 0);
+        for (int len = 2; len <= m; ++len) log2_floor[len] = log2_floor[len / 2] + 1;
+        sparse.push_back(move(gaps));
+        for (int k = 1; (1 << k) <= m; ++k) {
+            const vector<int>& prev = sparse[k - 1];
+            vector<int> level(m - (1 << k) + 1);
+            for (size_t i = 0; i < level.size(); ++i) level[i] = max(prev[i], prev[i + (1 << (k - 1))]);
+            sparse.push_back(move(level));
+        }
+    }
+
+    // Самый тяжёлый вес на пути между u и v; 0 для u == v, -1, если пути нет
+    [[nodiscard]] int query(int u, int v) const {
+        if (u == v) return 0;
+        int l = position[u], r = position[v];
+        if (l > r) swap(l, r);
+        int k = log2_floor[r - l];
+        int result = max(sparse[k][l], sparse[k][r - (1 << k)]);
+        return result == NO_PATH ? -1 : result;
+    }
+
+    // Сколько байт занимает таблица
+    [[nodiscard]] size_t memory_bytes() const {
+        size_t bytes = (position.size() + log2_floor.size()) * sizeof(int);
+        for (const auto& level : sparse) bytes += level.size() * sizeof(int);
+        return bytes;
+    }
+};
+
+// Настройки измерения времени
+struct TimingOptions {
+    double min_sample_us = 2000; // Минимальная длительность одного замера: короткие вызовы повторяются
+    int warmup_samples = 2;      // Сколько замеров отбросить перед измерением (прогрев кэшей и предсказателя)
+    int samples = 15;            // Сколько замеров учитывать
+    bool perf_counters = true;   // Считать такты и инструкции через perf_event (если доступно)
+};
+
+// Результат измерения (все значения — на один вызов)
+struct TimingResult {
+    int iterations = 0;       // Вызовов в одном замере (подбирается автоматически)
+    int samples = 0;          // Сколько замеров учтено
+    double median_us = 0;     // Медиана
+    double mad_us = 0;        // Медианное абсолютное отклонение
+    double ci_low_us = 0;     // Нижняя граница 95% доверительного интервала медианы
+    double ci_high_us = 0;    // Верхняя граница
+    double cycles = -1;       // Тактов процессора (-1, если счётчики недоступны)
+    double instructions = -1; // Выполненных инструкций
+};
+
+// Счётчики тактов и инструкций через perf_event (только Linux, иначе недоступны)
+class PerfCounters {
+private:
+    int cycles_fd = -1, instructions_fd = -1;
+
+#ifdef __linux__
+    static int open_counter(uint64_t config, int group_fd) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group_fd == -1; // Группа включается через лидера
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+#endif
+
+public:
+    PerfCounters() {
+#ifdef __linux__
+        cycles_fd = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (cycles_fd >= 0) instructions_fd = open_counter(PERF_COUNT_HW_INSTRUCTIONS, cycles_fd);
+#endif
+    }
+    ~PerfCounters() {
+#ifdef __linux__
+        if (instructions_fd >= 0) close(instructions_fd);
+        if (cycles_fd >= 0) close(cycles_fd);
+#endif
+    }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const { return cycles_fd >= 0 && instructions_fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (!available()) return;
+        ioctl(cycles_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(cycles_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Останавливает счётчики и возвращает {такты, инструкции}
+    pair<long long, long long> stop() {
+        long long cycles = -1, instructions = -1;
+#ifdef __linux__
+        if (!available()) return {cycles, instructions};
+        ioctl(cycles_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if (read(cycles_fd, &cycles, sizeof(cycles)) != sizeof(cycles)) cycles = -1;
+        if (read(instructions_fd, &instructions, sizeof(instructions)) != sizeof(instructions)) instructions = -1;
+#endif
+        return {cycles, instructions};
+    }
+};
+
+// Закрепляет процесс за ядром cpu, чтобы планировщик не переносил его во время замеров
+bool pin_to_cpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    static_cast<void>(cpu);
+    return false;
+#endif
+}
+
+// Значение, которое компилятор обязан вычислить (защита от удаления "бесполезного" кода)
+volatile size_t benchmark_sink = 0;
+
+// Измеряет время вызова f: подбирает число повторов, чтобы замер длился не меньше
+// min_sample_us, отбрасывает прогревочные замеры и считает медиану, MAD и
+// доверительный интервал медианы по порядковым статистикам.
+template <typename Func>
+TimingResult measure_function(Func f, const TimingOptions& options) {
+    auto run = [&f](int iterations) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) f();
+        auto end = chrono::steady_clock::now();
+        return chrono::duration<double, micro>(end - start).count();
+    };
+
+    // Калибровка: увеличиваем число повторов, пока замер не станет достаточно длинным
+    TimingResult result;
+    int iterations = 1;
+    while (true) {
+        double elapsed = run(iterations);
+        if (elapsed >= options.min_sample_us || iterations >= (1 << 24)) break;
+        double scale = elapsed > 0 ? options.min_sample_us / elapsed * 1.2 : 10.0;
+        iterations = (int)min<double>(1 << 24, max<double>(iterations * 2.0, iterations * scale));
+    }
+    result.iterations = iterations;
+
+    for (int w = 0; w < options.warmup_samples; ++w) run(iterations);
+
+    PerfCounters counters;
+    bool use_counters = options.perf_counters && counters.available();
+    long long total_cycles = 0, total_instructions = 0;
+    vector<double> times(options.samples);
+    for (int sample = 0; sample < options.samples; ++sample) {
+        if (use_counters) counters.start();
+        times[sample] = run(iterations) / iterations;
+        if (use_counters) {
+            auto [cycles, instructions] = counters.stop();
+            total_cycles += cycles;
+            total_instructions += instructions;
+        }
+    }
+
+    sort(times.begin(), times.end());
+    int n = times.size();
+    auto median_of = [](const vector<double>& sorted) {
+        size_t m = sorted.size();
+        return m % 2 ? sorted[m / 2] : (sorted[m / 2 - 1] + sorted[m / 2]) / 2;
+    };
+    result.samples = n;
+    result.median_us = median_of(times);
+    vector<double> deviations(n);
+    for (int i = 0; i < n; ++i) deviations[i] = fabs(times[i] - result.median_us);
+    sort(deviations.begin(), deviations.end());
+    result.mad_us = median_of(deviations);
+
+    // 95% доверительный интервал медианы: порядковые статистики с номерами n/2 -+ 1.96 * sqrt(n) / 2
+    double half_width = 1.96 * sqrt((double)n) / 2;
+    int low = max(0, (int)floor(n / 2.0 - half_width));
+    int high = min(n - 1, (int)ceil(n / 2.0 + half_width) - 1);
+    result.ci_low_us = times[low];
+    result.ci_high_us = times[high];
+
+    if (use_counters) {
+        double calls = (double)n * iterations;
+        result.cycles = total_cycles / calls;
+        result.instructions = total_instructions / calls;
+    }
+    return result;
+}
+
+// Аллокатор с выравниванием на границу кэш-линии (64 байта), чтобы строки матрицы
+// начинались с выровненного адреса и подходили для векторных загрузок
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    static constexpr size_t alignment = 64;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+// Матрица смежности в одном непрерывном буфере (по строкам). Каждая строка дополнена
+// нулями до кратного 64 байтам размера, поэтому все строки выровнены одинаково.
+// Weight — тип веса: uint8_t / uint16_t / int32_t (веса 1..20 помещаются в байт).
+template <typename Weight>
+class FlatMatrix {
+private:
+    int size = 0;      // Количество строк и столбцов
+    size_t stride = 0; // Длина строки в элементах с учётом выравнивания
+    vector<Weight, AlignedAllocator<Weight>> data; // Все строки подряд
+
+public:
+    FlatMatrix() = default;
+    explicit FlatMatrix(int n) : size(n) {
+        size_t per_line = AlignedAllocator<Weight>::alignment / sizeof(Weight); // Элементов в кэш-линии
+        stride = (n + per_line - 1) / per_line * per_line;
+        data.assign(stride * n, Weight(0));
+    }
+
+    [[nodiscard]] Weight* row(int i) { return data.data() + i * stride; }
+    [[nodiscard]] const Weight* row(int i) const { return data.data() + i * stride; }
+    [[nodiscard]] Weight get(int i, int j) const { return data[i * stride + j]; }
+    void set(int i, int j, Weight w) { data[i * stride + j] = w; }
+
+    // Сколько байт занимает матрица
+    [[nodiscard]] size_t memory_bytes() const { return data.size() * sizeof(Weight); }
+};
+
+// Класс для работы с графом, где есть вершины и ребра с весами.
+// Weight — тип веса в матрице смежности (по умолчанию int, как раньше).
+template <typename Weight = int>
+class WeightedGraph {
+    static_assert(numeric_limits<Weight>::max() >= 20, "Weight type must hold edge weights 1..20");
+
+private:
+    int num_vertices; // Сколько всего вершин в графе
+    int min_edges;    // Минимум ребер, которые должны выходить из каждой вершины
+    GraphStorage storage; // Способ хранения ребер
+    FlatMatrix<Weight> adj_matrix; // Матрица, где хранятся веса ребер между вершинами (только для AdjacencyMatrix)
+    vector<vector<pair<int, int>>> adj_list; // Списки (сосед, вес) для каждой вершины (только для AdjacencyList)
+    uint64_t seed;    // Зерно генерации: одинаковое зерно даёт одинаковый граф при любом числе потоков
+    mt19937 rng;      // Генератор случайных чисел для досоединения компонент
+    int edge_count = 0;        // Сколько рёбер в графе
+    mutable int component_count;       // Сколько компонент связности
+    mutable DisjointSet components;    // Компоненты связности, пополняются при каждом добавлении ребра
+    mutable bool components_valid = true; // false после удаления ребра: компоненты пересчитываются при запросе
+    unique_ptr<DynamicMst> dynamic_mst; // Поддерживаемое MST (nullptr, пока не включено)
+    uint64_t version = 0;               // Номер версии графа: увеличивается при каждом изменении рёбер
+
+    // Последний построенный минимальный остовный лес; действителен, пока version не изменилась
+    struct MstCache {
+        uint64_t version = UINT64_MAX;
+        vector<Edge> forest;             // Рёбра леса в порядке возрастания веса
+        int total_weight = 0;
+        bool has_oracle = false;         // Построена ли таблица для запросов bottleneck_weight
+        BottleneckOracle oracle;
+    };
+    mutable MstCache mst_cache;
+
+    // Обновляет кэш MST, если граф менялся с момента последнего построения
+    const MstCache& cached_mst() const {
+        if (mst_cache.version != version) {
+            vector<Edge> edges = collect_edges();
+            parallel_sort_edges(edges);
+            DisjointSet forest_components(num_vertices);
+            mst_cache.forest.clear();
+            mst_cache.total_weight = 0;
+            for (const Edge& e : edges) {
+                if (!forest_components.unite(e.u, e.v)) continue;
+                mst_cache.forest.push_back(e);
+                mst_cache.total_weight += e.weight;
             }
-            if (all_reachable) break; // Если все вершины связаны, выходим
+            mst_cache.has_oracle = false;
+            mst_cache.oracle = BottleneckOracle();
+            mst_cache.version = version;
         }
+        return mst_cache;
     }
 
-    // Считает, сколько ребер в графе
-    [[nodiscard]] int count_edges() const {
-        int edges = 0;
-        for (int i = 0; i < num_vertices; ++i) {
-            for (int j = 0; j < num_vertices; ++j) {
-                if (adj_matrix[i][j] > 0) edges++; // Если есть ребро, увеличиваем счетчик
+    // Пересчитывает компоненты связности заново (нужно только после удаления рёбер)
+    void rebuild_components() const {
+        components = DisjointSet(num_vertices);
+        component_count = num_vertices;
+        for (int u = 0; u < num_vertices; ++u) {
+            for_each_neighbor(u, [&](int v, int) {
+                if (u < v && components.unite(u, v)) component_count--;
+            });
+        }
+        components_valid = true;
+    }
+
+    // Вес ребра между u и v (0, если ребра нет)
+    [[nodiscard]] int edge_weight(int u, int v) const {
+        if (storage == GraphStorage::AdjacencyMatrix) return adj_matrix.get(u, v);
+        for (const auto& [to, weight] : adj_list[u]) {
+            if (to == v) return weight;
+        }
+        return 0;
+    }
+
+    // Добавляет неориентированное ребро (u, v) с весом weight и обновляет счётчики рёбер и компонент.
+    // Для списков смежности ребра (u, v) ещё не должно быть; в матрице существующий вес перезаписывается.
+    void set_edge(int u, int v, int weight) {
+        if (storage == GraphStorage::AdjacencyList || adj_matrix.get(u, v) == 0) edge_count++;
+        version++;
+        if (components_valid && components.unite(u, v)) component_count--;
+        if (storage == GraphStorage::AdjacencyMatrix) {
+            adj_matrix.set(u, v, weight);
+            adj_matrix.set(v, u, weight);
+        } else {
+            adj_list[u].emplace_back(v, weight);
+            adj_list[v].emplace_back(u, weight);
+        }
+    }
+
+    // Вызывает f(сосед, вес) для каждого соседа вершины u
+    template <typename Func>
+    void for_each_neighbor(int u, Func f) const {
+        if (storage == GraphStorage::AdjacencyMatrix) {
+            const Weight* row = adj_matrix.row(u);
+            for (int v = 0; v < num_vertices; ++v) {
+                if (row[v] > 0) f(v, int(row[v]));
+            }
+        } else {
+            for (const auto& [v, weight] : adj_list[u]) f(v, weight);
+        }
+    }
+
+    // Делает граф связным: компоненты уже известны из системы непересекающихся множеств,
+    // поэтому за один проход раскладываем вершины по компонентам и соединяем каждую
+    // следующую компоненту ребром со случайной вершиной из уже соединённых. O(V + k).
+    void ensure_connectivity() {
+        if (!components_valid) rebuild_components();
+        if (component_count <= 1) return;
+
+        // Раскладываем вершины по компонентам (порядок компонент — по первой встреченной вершине)
+        vector<int> component_index(num_vertices, -1); // Номер компоненты для её представителя
+        vector<vector<int>> members;
+        for (int v = 0; v < num_vertices; ++v) {
+            int root = components.find(v);
+            if (component_index[root] == -1) {
+                component_index[root] = members.size();
+                members.emplace_back();
             }
+            members[component_index[root]].push_back(v);
+        }
+
+        vector<int> linked = members[0]; // Вершины, уже соединённые с компонентой вершины 0
+        uniform_int_distribution<int> weight_dist(1, 20);
+        for (size_t c = 1; c < members.size(); ++c) {
+            // Выбираем случайную вершину новой компоненты и случайную уже соединённую вершину
+            uniform_int_distribution<size_t> member_dist(0, members[c].size() - 1);
+            uniform_int_distribution<size_t> linked_dist(0, linked.size() - 1);
+            int vertex = members[c][member_dist(rng)];
+            int connect_to = linked[linked_dist(rng)];
+            int weight = weight_dist(rng); // Вес ребра — случайное число от 1 до 20
+            set_edge(connect_to, vertex, weight); // Добавляем ребро в обе стороны (граф неориентированный)
+            linked.insert(linked.end(), members[c].begin(), members[c].end());
         }
-        return edges / 2; // Делим на 2, потому что каждое ребро учтено дважды (i, j и j, i)
     }
 
-    // Проверяет, связный ли граф (можно ли дойти от одной вершины до всех остальных)
+    // Считает, сколько ребер в графе (счётчик поддерживается при добавлении рёбер)
+    [[nodiscard]] int count_edges() const {
+        return edge_count;
+    }
+
+    // Проверяет, связный ли граф (можно ли дойти от одной вершины до всех остальных).
+    // Число компонент поддерживается системой непересекающихся множеств при добавлении рёбер.
     [[nodiscard]] bool is_connected() const {
-        vector<bool> visited(num_vertices, false); // Отмечаем посещенные вершины
-        queue<int> q; // Очередь для обхода
-        q.push(0);    // Начинаем с вершины 0
-        visited[0] = true;
-
-        while (!q.empty()) {
-            int vertex = q.front(); // Берем вершину из очереди
-            q.pop();
-            for (int i = 0; i < num_vertices; ++i) {
-                if (adj_matrix[vertex][i] > 0 && !visited[i]) { // Если есть ребро и вершина не посещена
-                    visited[i] = true; // Отмечаем ее
-                    q.push(i);         // Добавляем в очередь
+        if (!components_valid) rebuild_components();
+        return component_count <= 1;
+    }
+
+    // Прим за O(V^2): линейный поиск вершины с минимальным ключом.
+    // Для несвязного графа строит остовный лес: недостижимая вершина начинает новое дерево
+    [[nodiscard]] vector<pair<int, int>> prim_dense(int& total_weight) const {
+        if (storage == GraphStorage::AdjacencyMatrix) return prim_dense_matrix(total_weight);
+
+        vector<bool> in_mst(num_vertices, false); // Какие вершины уже в MST
+        vector<int> key(num_vertices, INT_MAX);   // Минимальный вес ребра до вершины
+        vector<int> parent(num_vertices, -1);     // Родитель вершины в MST
+        vector<pair<int, int>> mst_edges;         // Список ребер MST
+
+        key[0] = 0; // Начинаем с вершины 0, вес до нее 0
+        total_weight = 0;
+
+        for (int count = 0; count < num_vertices; ++count) {
+            // Ищем вершину с минимальным весом, которая еще не в MST
+            int u = -1;
+            for (int v = 0; v < num_vertices; ++v) {
+                if (!in_mst[v] && (u == -1 || key[v] < key[u])) {
+                    u = v;
+                }
+            }
+
+            in_mst[u] = true; // Добавляем вершину в MST
+            if (parent[u] != -1) { // Если у вершины есть родитель, добавляем ребро
+                mst_edges.emplace_back(parent[u], u);
+            }
+            if (key[u] != INT_MAX) total_weight += key[u]; // Прибавляем вес ребра (у корня нового дерева его нет)
+
+            // Обновляем веса для соседей вершины u
+            for_each_neighbor(u, [&](int v, int weight) {
+                if (!in_mst[v] && weight < key[v]) {
+                    key[v] = weight; // Уменьшаем вес, если нашли путь короче
+                    parent[v] = u;   // Запоминаем родителя
                 }
+            });
+        }
+
+        return mst_edges; // Возвращаем ребра MST
+    }
+
+    // Плотный Прим по матрице: обновление ключей по строке u и поиск следующей вершины
+    // выполняются одним проходом векторного ядра prim_row_update. Ядро может вернуть вершину
+    // с ключом KEY_UNREACHED — тогда компонента исчерпана и вершина начинает новое дерево леса
+    [[nodiscard]] vector<pair<int, int>> prim_dense_matrix(int& total_weight) const {
+        vector<int> key(num_vertices, KEY_UNREACHED); // Минимальный вес ребра до вершины (KEY_IN_MST — уже в дереве)
+        vector<int> parent(num_vertices, -1);         // Родитель вершины в MST
+        vector<pair<int, int>> mst_edges;             // Список ребер MST
+        mst_edges.reserve(num_vertices - 1);
+        SimdLevel level = prim_simd_level;
+
+        key[0] = 0; // Начинаем с вершины 0, вес до нее 0
+        total_weight = 0;
+        int u = 0;
+        for (int count = 0; count < num_vertices && u != -1; ++count) {
+            if (key[u] != KEY_UNREACHED) total_weight += key[u]; // Прибавляем вес ребра к общему весу
+            if (parent[u] != -1) mst_edges.emplace_back(parent[u], u);
+            key[u] = KEY_IN_MST; // Добавляем вершину в MST
+            u = prim_row_update(level, adj_matrix.row(u), num_vertices, u, key.data(), parent.data());
+        }
+        return mst_edges;
+    }
+
+    // Прим с "ленивой" бинарной кучей: вместо decrease-key кладём новую запись,
+    // а устаревшие записи (вершина уже в MST) отбрасываем при извлечении. O(E log E).
+    // Каждая ещё не покрытая вершина начинает новое дерево, так что несвязный граф даёт лес
+    [[nodiscard]] vector<pair<int, int>> prim_lazy_heap(int& total_weight) const {
+        struct Entry {
+            int weight, vertex, parent;
+            bool operator>(const Entry& other) const { return weight > other.weight; }
+        };
+        priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+        vector<bool> in_mst(num_vertices, false);
+        vector<pair<int, int>> mst_edges;
+        mst_edges.reserve(num_vertices - 1);
+        total_weight = 0;
+
+        for (int root = 0; root < num_vertices; ++root) {
+            if (in_mst[root]) continue;
+            pq.push({0, root, -1});
+            while (!pq.empty()) {
+                Entry top = pq.top();
+                pq.pop();
+                if (in_mst[top.vertex]) continue; // Устаревшая запись
+                in_mst[top.vertex] = true;
+                total_weight += top.weight;
+                if (top.parent != -1) mst_edges.emplace_back(top.parent, top.vertex);
+
+                for_each_neighbor(top.vertex, [&](int v, int weight) {
+                    if (!in_mst[v]) pq.push({weight, v, top.vertex});
+                });
             }
         }
+        return mst_edges;
+    }
+
+    // Прим с кучей, поддерживающей decrease-key (IndexedDaryHeap или PairingHeap). O(E log V).
+    // Как и остальные реализации, на несвязном графе строит остовный лес
+    template <typename Heap>
+    [[nodiscard]] vector<pair<int, int>> prim_with_heap(int& total_weight) const {
+        Heap heap(num_vertices);
+        vector<bool> in_mst(num_vertices, false);
+        vector<int> parent(num_vertices, -1);
+        vector<pair<int, int>> mst_edges;
+        mst_edges.reserve(num_vertices - 1);
+        total_weight = 0;
+
+        for (int root = 0; root < num_vertices; ++root) {
+            if (in_mst[root]) continue;
+            heap.push_or_decrease(root, 0);
+            while (!heap.empty()) {
+                int u = heap.pop_min();
+                in_mst[u] = true;
+                total_weight += heap.get_key(u);
+                if (parent[u] != -1) mst_edges.emplace_back(parent[u], u);
+
+                for_each_neighbor(u, [&](int v, int weight) {
+                    if (in_mst[v]) return;
+                    if (!heap.contains(v) || weight < heap.get_key(v)) {
+                        heap.push_or_decrease(v, weight);
+                        parent[v] = u;
+                    }
+                });
+            }
+        }
+        return mst_edges;
+    }
+
+    // Собирает все рёбра графа (каждое один раз, u < v)
+    [[nodiscard]] vector<Edge> collect_edges() const {
+        vector<Edge> edges;
+        for (int u = 0; u < num_vertices; ++u) {
+            for_each_neighbor(u, [&](int v, int weight) {
+                if (u < v) edges.push_back({u, v, weight});
+            });
+        }
+        return edges;
+    }
+
+    // Краскал: рёбра сортируются по весу параллельно, затем добавляются, если соединяют разные компоненты
+    [[nodiscard]] vector<pair<int, int>> kruskal_mst(int& total_weight) const {
+        vector<Edge> edges = collect_edges();
+        parallel_sort_edges(edges);
+
+        DisjointSet forest_components(num_vertices);
+        vector<pair<int, int>> mst_edges;
+        mst_edges.reserve(num_vertices - 1);
+        total_weight = 0;
+        for (const Edge& e : edges) {
+            if (!forest_components.unite(e.u, e.v)) continue; // Ребро замкнуло бы цикл
+            mst_edges.emplace_back(e.u, e.v);
+            total_weight += e.weight;
+            if ((int)mst_edges.size() == num_vertices - 1) break; // Дерево построено
+        }
+        return mst_edges;
+    }
+
+    // Борувка: в каждом раунде для каждой компоненты ищется самое лёгкое выходящее ребро
+    // (рёбра делятся между потоками, у каждого потока свой массив минимумов), затем
+    // компоненты стягиваются по найденным рёбрам. Раундов не больше log V.
+    [[nodiscard]] vector<pair<int, int>> boruvka_mst(int& total_weight) const {
+        vector<Edge> edges = collect_edges();
+        DisjointSet forest_components(num_vertices);
+        vector<int> component_of(num_vertices); // Представитель компоненты каждой вершины в текущем раунде
+        vector<pair<int, int>> mst_edges;
+        mst_edges.reserve(num_vertices - 1);
+        total_weight = 0;
+
+        int threads = worker_count();
+        // Лучшее ребро каждой компоненты для каждого потока (индекс в edges, -1 — нет)
+        vector<vector<int>> local_best(threads, vector<int>(num_vertices, -1));
+        vector<int> best(num_vertices, -1);
+
+        // Ребро a легче ребра b; равные веса различаем по индексу, чтобы не образовать цикл
+        auto lighter = [&edges](int a, int b) {
+            return b == -1 || edges[a].weight < edges[b].weight || (edges[a].weight == edges[b].weight && a < b);
+        };
+
+        while (true) {
+            for (int v = 0; v < num_vertices; ++v) component_of[v] = forest_components.find(v);
+
+            // Параллельный поиск минимальных рёбер: потоки только читают component_of и edges
+            parallel_for_chunks(edges.size(), threads, [&](size_t begin, size_t end, int t) {
+                vector<int>& mine = local_best[t];
+                fill(mine.begin(), mine.end(), -1);
+                for (size_t i = begin; i < end; ++i) {
+                    int cu = component_of[edges[i].u], cv = component_of[edges[i].v];
+                    if (cu == cv) continue;
+                    if (lighter(i, mine[cu])) mine[cu] = i;
+                    if (lighter(i, mine[cv])) mine[cv] = i;
+                }
+            });
 
-        // Если все вершины посещены, граф связный
-        return all_of(visited.begin(), visited.end(), [](bool v) { return v; });
+            // Сводим результаты потоков
+            fill(best.begin(), best.end(), -1);
+            for (const auto& mine : local_best) {
+                for (int c = 0; c < num_vertices; ++c) {
+                    if (mine[c] != -1 && lighter(mine[c], best[c])) best[c] = mine[c];
+                }
+            }
+
+            // Стягиваем компоненты по найденным рёбрам
+            bool merged = false;
+            for (int c = 0; c < num_vertices; ++c) {
+                if (best[c] == -1) continue;
+                const Edge& e = edges[best[c]];
+                if (forest_components.unite(e.u, e.v)) {
+                    mst_edges.emplace_back(e.u, e.v);
+                    total_weight += e.weight;
+                    merged = true;
+                }
+            }
+            if (!merged) break; // Все компоненты уже соединены
+
+            // Выбрасываем рёбра, ставшие внутренними, чтобы следующие раунды были быстрее
+            edges.erase(remove_if(edges.begin(), edges.end(), [&forest_components](const Edge& e) {
+                return forest_components.find(e.u) == forest_components.find(e.v);
+            }), edges.end());
+            if (edges.empty()) break;
+        }
+        return mst_edges;
     }
 
 public:
     // Создаем граф с заданным числом вершин и минимальным количеством ребер
-    WeightedGraph(int vertices, int min_e)
-            : num_vertices(vertices), min_edges(min_e), rng(random_device{}()) {
-        adj_matrix = vector<vector<int>>(num_vertices, vector<int>(num_vertices, 0));
+    WeightedGraph(int vertices, int min_e, GraphStorage storage_type = GraphStorage::AdjacencyMatrix,
+                  uint64_t graph_seed = random_device{}())
+            : num_vertices(vertices), min_edges(min_e), storage(storage_type), seed(graph_seed),
+              rng(uint32_t(graph_seed ^ (graph_seed >> 32))),
+              component_count(vertices), components(vertices) {
+        if (storage == GraphStorage::AdjacencyMatrix) {
+            adj_matrix = FlatMatrix<Weight>(num_vertices);
+        } else {
+            adj_list.resize(num_vertices);
+        }
         generate_graph();    // Создаем случайный граф
         ensure_connectivity(); // Убеждаемся, что он связный
     }
 
+    // Вес ребра должен помещаться в Weight и быть положительным: 0 в матрице означает
+    // "нет ребра", а обрезанный вес (256 для uint8_t) незаметно превратился бы в 0
+    static void check_weight(int weight) {
+        if (weight < 1 || (long long)weight > (long long)numeric_limits<Weight>::max()) {
+            throw invalid_argument("edge weight " + to_string(weight) + " is outside [1, " +
+                                   to_string((long long)numeric_limits<Weight>::max()) + "]");
+        }
+    }
+
+    // Добавляет ребро (u, v); если оно уже есть, меняет его вес.
+    // Вес вне [1, numeric_limits<Weight>::max()] отклоняется исключением invalid_argument
+    void insert_edge(int u, int v, int weight) {
+        check_weight(weight);
+        if (edge_weight(u, v) != 0) {
+            update_edge_weight(u, v, weight);
+            return;
+        }
+        set_edge(u, v, weight);
+        if (dynamic_mst) dynamic_mst->on_insert(u, v, weight);
+    }
+
+    // Удаляет ребро (u, v); возвращает false, если ребра не было
+    bool remove_edge(int u, int v) {
+        if (edge_weight(u, v) == 0) return false;
+        if (storage == GraphStorage::AdjacencyMatrix) {
+            adj_matrix.set(u, v, 0);
+            adj_matrix.set(v, u, 0);
+        } else {
+            for (auto [from, to] : {pair<int, int>{u, v}, pair<int, int>{v, u}}) {
+                auto& neighbors = adj_list[from];
+                auto it = find_if(neighbors.begin(), neighbors.end(), [to = to](const pair<int, int>& p) { return p.first == to; });
+                *it = neighbors.back();
+                neighbors.pop_back();
+            }
+        }
+        edge_count--;
+        version++;
+        components_valid = false; // Удаление могло разбить компоненту, пересчитаем при запросе
+        if (dynamic_mst) {
+            dynamic_mst->on_remove(u, v, [this](int x, auto f) { for_each_neighbor(x, f); });
+        }
+        return true;
+    }
+
+    // Меняет вес существующего ребра (u, v); если ребра нет, добавляет его.
+    // Допустимые веса те же, что и в insert_edge
+    void update_edge_weight(int u, int v, int weight) {
+        check_weight(weight);
+        int old_weight = edge_weight(u, v);
+        if (old_weight == 0) {
+            insert_edge(u, v, weight);
+            return;
+        }
+        if (storage == GraphStorage::AdjacencyMatrix) {
+            adj_matrix.set(u, v, weight);
+            adj_matrix.set(v, u, weight);
+        } else {
+            for (auto& p : adj_list[u]) if (p.first == v) p.second = weight;
+            for (auto& p : adj_list[v]) if (p.first == u) p.second = weight;
+        }
+        version++;
+        if (dynamic_mst) {
+            dynamic_mst->on_reweight(u, v, old_weight, weight, [this](int x, auto f) { for_each_neighbor(x, f); });
+        }
+    }
+
+    // Включает поддержку MST при изменениях графа: дерево строится один раз (Краскалом),
+    // дальше insert_edge / remove_edge / update_edge_weight обновляют его инкрементально
+    void enable_dynamic_mst() {
+        int total_weight = 0;
+        vector<Edge> tree;
+        for (auto [u, v] : kruskal_mst(total_weight)) tree.push_back({u, v, edge_weight(u, v)});
+        dynamic_mst = make_unique<DynamicMst>(num_vertices, tree);
+    }
+
+    // Вес поддерживаемого MST (нужно сначала вызвать enable_dynamic_mst)
+    [[nodiscard]] long long dynamic_mst_weight() const {
+        return dynamic_mst ? dynamic_mst->get_total_weight() : -1;
+    }
+
     // Создает случайный граф
     void generate_graph() {
-        for (int i = 0; i < num_vertices; ++i) {
-            vector<int> possible_connections; // Список вершин, с которыми можно соединить
-            for (int j = 0; j < num_vertices; ++j) {
-                if (j != i) possible_connections.push_back(j);
+        // Вершина i выбирает k соседей алгоритмом Флойда: k различных чисел из [0, V-2] за O(k)
+        // (число j >= i означает вершину j+1). Случайность вершины i — свой поток CounterRng,
+        // поэтому блоки вершин генерируются параллельно и граф зависит только от seed.
+        // Выборки копятся в плоском буфере порциями ограниченного размера и затем
+        // последовательно добавляются в граф, пропуская рёбра, которые уже выбрала другая вершина.
+        const int max_connections = min(num_vertices - 1, min_edges * 2);
+        const size_t batch_limit = size_t(1) << 22; // Сколько выборок держать в памяти одновременно
+        int threads = worker_count();
+
+        vector<int> degree(num_vertices);  // Сколько соседей выбирает вершина
+        vector<size_t> offset(num_vertices + 1, 0);
+        vector<pair<int, int>> samples;    // (сосед, вес) для вершин текущей порции
+        vector<vector<char>> marked(threads, vector<char>(num_vertices, 0)); // Уже выбранные соседи (для каждой нити)
+
+        for (int first = 0; first < num_vertices;) {
+            // Набираем порцию вершин [first, last), суммарно выбирающих не больше batch_limit соседей
+            int last = first;
+            offset[first] = 0;
+            while (last < num_vertices && (last == first || offset[last] + max_connections <= batch_limit)) {
+                CounterRng stream(seed, last);
+                degree[last] = max_connections > 0 ? stream.uniform(min(min_edges, max_connections), max_connections) : 0;
+                offset[last + 1] = offset[last] + degree[last];
+                last++;
             }
-            // Решаем, сколько ребер будет у вершины (от min_edges до 2*min_edges)
-            uniform_int_distribution<int> conn_dist(min_edges, min(num_vertices-1, min_edges * 2));
-            int num_connections = conn_dist(rng);
-            shuffle(possible_connections.begin(), possible_connections.end(), rng); // Перемешиваем вершины
-
-            // Добавляем ребра к случайным вершинам
-            for (int j = 0; j < num_connections && j < possible_connections.size(); ++j) {
-                int target = possible_connections[j];
-                if (adj_matrix[i][target] == 0) { // Если ребра еще нет
-                    uniform_int_distribution<int> weight_dist(1, 20);
-                    int weight = weight_dist(rng); // Вес ребра — случайное число
-                    adj_matrix[i][target] = weight;
-                    adj_matrix[target][i] = weight; // Граф неориентированный
+            samples.resize(offset[last]);
+
+            parallel_for_chunks(last - first, threads, [&](size_t begin, size_t end, int t) {
+                vector<char>& used = marked[t];
+                for (int i = first + (int)begin; i < first + (int)end; ++i) {
+                    CounterRng stream(seed, i);
+                    stream.next(); // Первое число потока ушло на выбор степени
+                    int k = degree[i], pool = num_vertices - 1;
+                    pair<int, int>* out = samples.data() + offset[i];
+                    for (int j = pool - k; j < pool; ++j) {
+                        int candidate = stream.uniform(0, j);
+                        if (used[candidate]) candidate = j; // j ещё не мог быть выбран
+                        used[candidate] = 1;
+                        *out++ = {candidate >= i ? candidate + 1 : candidate, stream.uniform(1, 20)}; // Вес от 1 до 20
+                    }
+                    for (int j = 0; j < k; ++j) {
+                        int candidate = samples[offset[i] + j].first;
+                        used[candidate > i ? candidate - 1 : candidate] = 0; // Сбрасываем только то, что пометили
+                    }
+                }
+            });
+
+            for (int i = first; i < last; ++i) {
+                for (size_t j = offset[i]; j < offset[i + 1]; ++j) {
+                    auto [target, weight] = samples[j];
+                    if (edge_weight(i, target) == 0) set_edge(i, target, weight); // Если ребра еще нет
                 }
             }
+            first = last;
         }
     }
 
@@ -141,7 +1657,7 @@ public:
         for (int i = 0; i < num_vertices; ++i) {
             cout << setw(2) << i << " |";
             for (int j = 0; j < num_vertices; ++j) {
-                cout << setw(3) << adj_matrix[i][j] << " ";
+                cout << setw(3) << edge_weight(i, j) << " ";
             }
             cout << "\n";
         }
@@ -149,111 +1665,349 @@ public:
 
     // Находит минимальное остовное дерево (MST) с помощью алгоритма Прима
     [[nodiscard]] vector<pair<int, int>> prim_mst(int& total_weight) const {
-        vector<bool> in_mst(num_vertices, false); // Какие вершины уже в MST
-        vector<int> key(num_vertices, INT_MAX);   // Минимальный вес ребра до вершины
-        vector<int> parent(num_vertices, -1);     // Родитель вершины в MST
-        vector<pair<int, int>> mst_edges;         // Список ребер MST
-
-        key[0] = 0; // Начинаем с вершины 0, вес до нее 0
-        total_weight = 0;
+        return prim_dense(total_weight);
+    }
 
-        for (int count = 0; count < num_vertices; ++count) {
-            // Ищем вершину с минимальным весом, которая еще не в MST
-            int u = -1;
-            for (int v = 0; v < num_vertices; ++v) {
-                if (!in_mst[v] && (u == -1 || key[v] < key[u])) {
-                    u = v;
-                }
-            }
+    // Находит MST выбранным алгоритмом; все алгоритмы возвращают рёбра и общий вес в одном формате
+    // (для несвязного графа — минимальный остовный лес, как minimum_spanning_forest)
+    [[nodiscard]] vector<pair<int, int>> minimum_spanning_tree(int& total_weight, MstAlgorithm algorithm) const {
+        switch (algorithm) {
+            case MstAlgorithm::PrimLazyBinaryHeap: return prim_lazy_heap(total_weight);
+            case MstAlgorithm::PrimIndexedDaryHeap: return prim_with_heap<IndexedDaryHeap>(total_weight);
+            case MstAlgorithm::PrimPairingHeap: return prim_with_heap<PairingHeap>(total_weight);
+            case MstAlgorithm::Kruskal: return kruskal_mst(total_weight);
+            case MstAlgorithm::Boruvka: return boruvka_mst(total_weight);
+            case MstAlgorithm::PrimDense: break;
+        }
+        return prim_dense(total_weight);
+    }
 
-            in_mst[u] = true; // Добавляем вершину в MST
-            if (parent[u] != -1) { // Если у вершины есть родитель, добавляем ребро
-                mst_edges.emplace_back(parent[u], u);
-            }
-            total_weight += key[u]; // Прибавляем вес ребра к общему весу
+    // Минимальный остовный лес (для связного графа — MST) с общим весом.
+    // Результат кэшируется и пересчитывается только после изменения графа.
+    [[nodiscard]] const vector<Edge>& minimum_spanning_forest(int& total_weight) const {
+        const MstCache& cache = cached_mst();
+        total_weight = cache.total_weight;
+        return cache.forest;
+    }
 
-            // Обновляем веса для соседей вершины u
-            for (int v = 0; v < num_vertices; ++v) {
-                if (adj_matrix[u][v] > 0 && !in_mst[v] && adj_matrix[u][v] < key[v]) {
-                    key[v] = adj_matrix[u][v]; // Уменьшаем вес, если нашли путь короче
-                    parent[v] = u;             // Запоминаем родителя
-                }
-            }
+    // Самый тяжёлый вес ребра на пути между u и v в минимальном остовном лесу
+    // (минимально возможный "максимальный вес" среди всех путей u-v в графе).
+    // 0 для u == v, -1, если u и v в разных компонентах. Таблица строится при первом запросе
+    // после изменения графа за O(V log V), дальше каждый запрос — O(1).
+    [[nodiscard]] int bottleneck_weight(int u, int v) const {
+        cached_mst();
+        if (!mst_cache.has_oracle) {
+            mst_cache.oracle = BottleneckOracle(num_vertices, mst_cache.forest);
+            mst_cache.has_oracle = true;
         }
-
-        return mst_edges; // Возвращаем ребра MST
+        return mst_cache.oracle.query(u, v);
     }
 
     // Показывает минимальное остовное дерево
     void print_mst() const {
         int total_weight = 0;
-        vector<pair<int, int>> mst = prim_mst(total_weight);
+        const vector<Edge>& mst = minimum_spanning_forest(total_weight);
         cout << "\nMinimum Spanning Tree edges:\n";
-        for (const auto& edge : mst) {
-            int u = edge.first;
-            int v = edge.second;
-            cout << "(" << u << ", " << v << ") weight: " << adj_matrix[u][v] << "\n";
+        for (const Edge& edge : mst) {
+            cout << "(" << edge.u << ", " << edge.v << ") weight: " << edge.weight << "\n";
         }
         cout << "Total MST weight: " << total_weight << "\n";
     }
 
-    // Замеряет, сколько времени занимает алгоритм Прима
-    [[nodiscard]] double measure_prim_time() const {
-        int total_weight = 0;
-        auto start = chrono::high_resolution_clock::now(); // Засекаем время начала
-        static_cast<void>(prim_mst(total_weight)); // Запускаем алгоритм
-        auto end = chrono::high_resolution_clock::now();   // Засекаем время конца
-        return chrono::duration<double, micro>(end - start).count(); // Считаем разницу в микросекундах
+    [[nodiscard]] int get_num_vertices() const { return num_vertices; }
+    [[nodiscard]] int get_num_edges() const { return count_edges(); }
+    [[nodiscard]] GraphStorage get_storage() const { return storage; }
+
+    // Сколько байт занимают рёбра графа (матрица или списки смежности)
+    [[nodiscard]] size_t memory_bytes() const {
+        size_t bytes = adj_matrix.memory_bytes();
+        for (const auto& neighbors : adj_list) bytes += neighbors.capacity() * sizeof(neighbors[0]);
+        return bytes;
     }
 };
 
-// Главная функция программы
-int main() {
+// Название типа веса для вывода и CSV
+template <typename Weight>
+const char* weight_type_name() {
+    if constexpr (sizeof(Weight) == 1) return is_signed<Weight>::value ? "int8" : "uint8";
+    else if constexpr (sizeof(Weight) == 2) return is_signed<Weight>::value ? "int16" : "uint16";
+    else return is_signed<Weight>::value ? "int32" : "uint32";
+}
+
+// Добавляет в общий CSV строку с результатом замера операции name на графе
+template <typename Weight>
+void write_timing_row(ofstream& csv, const char* section, const WeightedGraph<Weight>& graph,
+                      const char* name, const char* simd, const TimingResult& r) {
+    const char* storage = graph.get_storage() == GraphStorage::AdjacencyMatrix ? "matrix" : "list";
+    csv << section << "," << graph.get_num_vertices() << "," << graph.get_num_edges() << "," << storage << ","
+        << weight_type_name<Weight>() << "," << name << "," << simd << ","
+        << r.iterations << "," << r.samples << "," << fixed << setprecision(3) << r.median_us << "," << r.mad_us << ","
+        << r.ci_low_us << "," << r.ci_high_us << "," << setprecision(0) << r.cycles << "," << r.instructions << "\n";
+}
+
+// Измеряет алгоритм MST на графе, печатает сводку и добавляет строку в общий CSV
+template <typename Weight>
+void benchmark_mst(ofstream& csv, const char* section, const WeightedGraph<Weight>& graph,
+                   MstAlgorithm algorithm, const TimingOptions& options) {
+    // Вес, который вернул сам измеряемый алгоритм (один вызов вне замера), сверяем с эталонным лесом из кэша
+    int total_weight = 0, reference_weight = 0;
+    static_cast<void>(graph.minimum_spanning_tree(total_weight, algorithm));
+    static_cast<void>(graph.minimum_spanning_forest(reference_weight));
+    TimingResult r = measure_function([&graph, algorithm]() {
+        int weight = 0;
+        benchmark_sink = graph.minimum_spanning_tree(weight, algorithm).size() + weight;
+    }, options);
+
+    bool dense_kernel = algorithm == MstAlgorithm::PrimDense && graph.get_storage() == GraphStorage::AdjacencyMatrix;
+    const char* simd = dense_kernel ? simd_level_name(prim_simd_level) : "-";
+
+    cout << setw(20) << mst_algorithm_name(algorithm) << (dense_kernel ? string(" [") + simd + "]" : string())
+         << ": median " << fixed << setprecision(3) << r.median_us << " mks, MAD " << r.mad_us
+         << ", 95% CI [" << r.ci_low_us << ", " << r.ci_high_us << "], x" << r.iterations
+         << ", MST weight " << total_weight;
+    if (total_weight != reference_weight) cout << " MISMATCH (reference " << reference_weight << ")";
+    cout << "\n";
+
+    write_timing_row(csv, section, graph, mst_algorithm_name(algorithm), simd, r);
+}
+
+// Проверяет, что каждый алгоритм (плотный Прим — на всех доступных уровнях SIMD) даёт тот же
+// вес и число рёбер, что и эталонный минимальный остовный лес. Печатает расхождения
+template <typename Weight>
+bool verify_mst_engines(const WeightedGraph<Weight>& graph, const string& label) {
+    int reference_weight = 0;
+    size_t reference_edges = graph.minimum_spanning_forest(reference_weight).size();
+    SimdLevel detected = prim_simd_level;
+    bool ok = true;
+    for (MstAlgorithm algorithm : all_mst_algorithms) {
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+            bool dense_kernel = algorithm == MstAlgorithm::PrimDense && graph.get_storage() == GraphStorage::AdjacencyMatrix;
+            if (level > detected || (!dense_kernel && level != SimdLevel::Scalar)) continue;
+            prim_simd_level = level;
+            int weight = 0;
+            size_t edges = graph.minimum_spanning_tree(weight, algorithm).size();
+            if (weight != reference_weight || edges != reference_edges) {
+                cout << "MISMATCH " << label << ": " << mst_algorithm_name(algorithm)
+                     << (dense_kernel ? string(" [") + simd_level_name(level) + "]" : string())
+                     << " weight " << weight << ", " << edges << " edges; expected " << reference_weight
+                     << ", " << reference_edges << " edges\n";
+                ok = false;
+            }
+        }
+    }
+    prim_simd_level = detected;
+    if (ok) cout << label << ": all engines agree (weight " << reference_weight << ", " << reference_edges << " edges)\n";
+    return ok;
+}
+
+// Сравнивает типы весов матрицы на плотном графе: память и время Прима O(V^2)
+template <typename Weight>
+void compare_weight_type(ofstream& csv, int vertices, int min_e, uint64_t seed, const TimingOptions& options) {
+    WeightedGraph<Weight> graph(vertices, min_e, GraphStorage::AdjacencyMatrix, seed); // Одно зерно — один и тот же граф
+    cout << setw(8) << weight_type_name<Weight>() << ": matrix " << fixed << setprecision(1)
+         << graph.memory_bytes() / (1024.0 * 1024.0) << " MiB\n";
+    benchmark_mst(csv, "weight_types", graph, MstAlgorithm::PrimDense, options);
+}
+
+// Главная функция программы.
+// Параметры: --pin=N — закрепить процесс за ядром N; --no-perf — не читать счётчики процессора;
+// --seed=S — зерно генерации графов (по умолчанию случайное).
+int main(int argc, char* argv[]) {
+    TimingOptions options;
+    uint64_t seed = random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--pin=", 0) == 0) {
+            int cpu = stoi(arg.substr(6));
+            cout << "Pinning to CPU " << cpu << ": " << (pin_to_cpu(cpu) ? "ok" : "failed") << "\n";
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = stoull(arg.substr(7));
+        } else if (arg == "--no-perf") {
+            options.perf_counters = false;
+        }
+    }
+    if (options.perf_counters && !PerfCounters().available()) {
+        cout << "perf_event counters are not available, cycles/instructions are reported as -1\n";
+    }
+    cout << "Graph seed: " << seed << "\n";
+
+    // Все результаты попадают в один CSV
+    ofstream csv_file("mst_benchmark.csv");
+    if (!csv_file.is_open()) {
+        cerr << "Error opening CSV file!" << endl;
+        return 1;
+    }
+    csv_file << "Section,Vertices,Edges,Storage,WeightType,Algorithm,Simd,Iterations,Samples,"
+                "Median_us,MAD_us,CI95_low_us,CI95_high_us,Cycles,Instructions\n";
+
     int vertex_counts[] = {10, 20, 50, 100}; // Размеры графов для тестов
     int min_edges[] = {3, 4, 10, 20};        // Минимальное число ребер для каждой вершины
-    const int num_tests = 10;                // Сколько раз тестируем каждый граф
-
-    cout << "Undirected graphs - Prim's MST Performance Tests:\n";
-    vector<vector<double>> test_results(4); // Здесь храним результаты тестов
 
+    cout << "Undirected graphs - MST Performance Tests:\n";
     for (int i = 0; i < 4; ++i) {
         cout << "\nGraph " << i+1 << " (" << vertex_counts[i] << " vertices):\n";
-        WeightedGraph graph(vertex_counts[i], min_edges[i]); // Создаем граф
+        WeightedGraph<uint8_t> graph(vertex_counts[i], min_edges[i], GraphStorage::AdjacencyMatrix, seed + i); // Создаем граф (веса 1..20 хранятся в байте)
         graph.print_adj_matrix(); // Показываем матрицу
         graph.print_mst();        // Показываем MST
 
-        cout << "\nRunning " << num_tests << " tests for Prim's MST...\n";
-        test_results[i].resize(num_tests);
-        for (int t = 0; t < num_tests; ++t) {
-            test_results[i][t] = graph.measure_prim_time(); // Замеряем время
-            cout << "Test " << t+1 << ": " << fixed << setprecision(3)
-                 << test_results[i][t] << " mks\n";
+        cout << "\n";
+        for (MstAlgorithm algorithm : all_mst_algorithms) {
+            benchmark_mst(csv_file, "small", graph, algorithm, options);
         }
+    }
 
-        // Считаем среднее время
-        double avg_time = 0;
-        for (double time : test_results[i]) avg_time += time;
-        avg_time /= num_tests;
-        cout << "Average time: " << fixed << setprecision(3) << avg_time << " mks\n";
+    // Несвязный граф: все алгоритмы должны вернуть один и тот же минимальный остовный лес.
+    // Изолируем вершину 0 (с неё начинают все варианты Прима) и одну вершину в середине
+    cout << "\nDisconnected graphs (spanning forest check):\n";
+    for (GraphStorage storage_type : {GraphStorage::AdjacencyMatrix, GraphStorage::AdjacencyList}) {
+        const int vertices = 50;
+        WeightedGraph<uint8_t> graph(vertices, 3, storage_type, seed);
+        for (int isolated : {0, vertices / 2}) {
+            for (int v = 0; v < vertices; ++v) graph.remove_edge(isolated, v);
+        }
+        verify_mst_engines(graph, storage_type == GraphStorage::AdjacencyMatrix ? "matrix" : "list");
     }
 
-    // Сохраняем результаты в файл
-    ofstream csv_file("prim_performance.csv");
-    if (!csv_file.is_open()) {
-        cerr << "Error opening CSV file!" << endl;
-        return 1;
+    // Для больших графов один вызов длится сотни миллисекунд: хватает меньшего числа замеров
+    TimingOptions long_options = options;
+    long_options.warmup_samples = 1;
+    long_options.samples = 5;
+
+    // Большой разреженный граф: O(V^2) Прим здесь неприменим, сравниваем остальные алгоритмы
+    {
+        const int big_vertices = 1000000;
+        cout << "\nSparse graph (" << big_vertices << " vertices, adjacency lists):\n";
+        auto build_start = chrono::high_resolution_clock::now();
+        WeightedGraph<> graph(big_vertices, 3, GraphStorage::AdjacencyList, seed);
+        auto build_end = chrono::high_resolution_clock::now();
+        cout << "Build time: " << fixed << setprecision(3)
+             << chrono::duration<double>(build_end - build_start).count() << " s\n";
+        for (MstAlgorithm algorithm : all_mst_algorithms) {
+            if (algorithm == MstAlgorithm::PrimDense) continue;
+            benchmark_mst(csv_file, "sparse", graph, algorithm, long_options);
+        }
+
+        // Запросы самого тяжёлого ребра на пути: таблица строится один раз, запросы — O(1)
+        const int queries = 1000000;
+        mt19937 query_rng(seed);
+        uniform_int_distribution<int> vertex_dist(0, big_vertices - 1);
+        vector<pair<int, int>> pairs(queries);
+        for (auto& [u, v] : pairs) u = vertex_dist(query_rng), v = vertex_dist(query_rng);
+        auto oracle_start = chrono::high_resolution_clock::now();
+        static_cast<void>(graph.bottleneck_weight(0, 0)); // Первый запрос строит таблицу
+        auto oracle_end = chrono::high_resolution_clock::now();
+        long long checksum = 0;
+        for (auto [u, v] : pairs) checksum += graph.bottleneck_weight(u, v);
+        auto queries_end = chrono::high_resolution_clock::now();
+        cout << "Bottleneck queries: table built in " << fixed << setprecision(3)
+             << chrono::duration<double, milli>(oracle_end - oracle_start).count() << " ms, "
+             << chrono::duration<double, nano>(queries_end - oracle_end).count() / queries
+             << " ns per query (average bottleneck " << double(checksum) / queries << ")\n";
     }
 
-    csv_file << "N,Average Time (mks)\n";
-    for (int i = 0; i < 4; ++i) {
-        double avg_time = 0;
-        for (double time : test_results[i]) avg_time += time;
-        avg_time /= num_tests;
-        csv_file << vertex_counts[i] << "," << fixed << setprecision(3) << avg_time << "\n";
+    // Инкрементальное обновление MST против полного пересчёта
+    {
+        const int vertices = 100000;
+        cout << "\nDynamic MST (" << vertices << " vertices, adjacency lists):\n";
+        WeightedGraph<> graph(vertices, 3, GraphStorage::AdjacencyList, seed);
+        graph.enable_dynamic_mst();
+
+        mt19937 update_rng(12345);
+        uniform_int_distribution<int> vertex_dist(0, vertices - 1), weight_dist(1, 20), op_dist(0, 2);
+        vector<pair<int, int>> inserted; // Добавленные рёбра: их потом меняем и удаляем
+        const int updates = 3000;
+        int performed = 0; // Фактически выполненные обновления (попытки с u == v пропускаются)
+        PerfCounters counters;
+        bool use_counters = options.perf_counters && counters.available();
+        if (use_counters) counters.start();
+        auto update_start = chrono::steady_clock::now();
+        for (int i = 0; i < updates; ++i) {
+            int op = inserted.empty() ? 0 : op_dist(update_rng);
+            if (op == 0) { // Добавление нового ребра
+                int u = vertex_dist(update_rng), v = vertex_dist(update_rng);
+                if (u == v) continue;
+                graph.insert_edge(u, v, weight_dist(update_rng));
+                inserted.emplace_back(u, v);
+            } else {
+                uniform_int_distribution<size_t> pick(0, inserted.size() - 1);
+                size_t k = pick(update_rng);
+                auto [u, v] = inserted[k];
+                if (op == 1) { // Изменение веса
+                    graph.update_edge_weight(u, v, weight_dist(update_rng));
+                } else { // Удаление
+                    graph.remove_edge(u, v);
+                    inserted[k] = inserted.back();
+                    inserted.pop_back();
+                }
+            }
+            performed++;
+        }
+        auto update_end = chrono::steady_clock::now();
+
+        // Обновления меняют граф, поэтому повторять их нельзя: это один замер на всю серию,
+        // разброс и доверительный интервал не определены и записываются равными медиане
+        TimingResult update_result;
+        update_result.iterations = performed;
+        update_result.samples = 1;
+        update_result.median_us = chrono::duration<double, micro>(update_end - update_start).count() / max(performed, 1);
+        update_result.ci_low_us = update_result.ci_high_us = update_result.median_us;
+        if (use_counters) {
+            auto [cycles, instructions] = counters.stop();
+            update_result.cycles = double(cycles) / max(performed, 1);
+            update_result.instructions = double(instructions) / max(performed, 1);
+        }
+        cout << "Average update latency: " << fixed << setprecision(3) << update_result.median_us << " mks over "
+             << performed << " updates\n";
+        write_timing_row(csv_file, "dynamic", graph, "DynamicUpdate", "-", update_result);
+
+        // Полный пересчёт тем же таймером, что и остальные алгоритмы; вес берётся из кэша MST
+        cout << "Full recompute:\n";
+        benchmark_mst(csv_file, "dynamic", graph, MstAlgorithm::Kruskal, long_options);
+        int recomputed_weight = 0;
+        static_cast<void>(graph.minimum_spanning_forest(recomputed_weight));
+        cout << "Maintained MST weight: " << graph.dynamic_mst_weight() << ", recomputed: " << recomputed_weight << "\n";
     }
-    csv_file.close();
 
-    cout << "\nResults saved to prim_performance.csv\n";
+    // remove_edge может разбить граф: после удаления последнего ребра вершины плотный Прим,
+    // остальные алгоритмы и поддерживаемый лес должны совпасть с minimum_spanning_forest
+    {
+        const int vertices = 64;
+        cout << "\nEdge removal that disconnects the graph (" << vertices << " vertices, matrix):\n";
+        WeightedGraph<uint8_t> graph(vertices, 3, GraphStorage::AdjacencyMatrix, seed);
+        graph.enable_dynamic_mst();
+        const int isolated = vertices / 3;
+        for (int v = 0; v < vertices; ++v) graph.remove_edge(isolated, v);
+        verify_mst_engines(graph, "after removal");
+        int forest_weight = 0;
+        static_cast<void>(graph.minimum_spanning_forest(forest_weight));
+        cout << "Maintained MST weight: " << graph.dynamic_mst_weight() << ", forest: " << forest_weight
+             << (graph.dynamic_mst_weight() == forest_weight ? "" : " MISMATCH") << "\n";
+    }
+
+    // Влияние типа веса в матрице смежности на память и скорость
+    cout << "\nDense graph (4000 vertices), matrix weight types:\n";
+    compare_weight_type<int32_t>(csv_file, 4000, 1000, seed, options);
+    compare_weight_type<uint16_t>(csv_file, 4000, 1000, seed, options);
+    compare_weight_type<uint8_t>(csv_file, 4000, 1000, seed, options);
+
+    // Векторное ядро плотного Прима на полных графах: здесь O(V^2) — правильный выбор
+    cout << "\nComplete graphs, dense Prim kernel, detected: " << simd_level_name(prim_simd_level) << "\n";
+    {
+        SimdLevel detected = prim_simd_level;
+        for (int vertices : {1000, 2000, 5000, 10000, 20000}) {
+            WeightedGraph<uint8_t> graph(vertices, vertices - 1, GraphStorage::AdjacencyMatrix, seed); // min_edges = V - 1 даёт полный граф
+            cout << "V=" << vertices << ":\n";
+            for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+                if (level > detected) continue; // Процессор не поддерживает этот набор инструкций
+                prim_simd_level = level;
+                benchmark_mst(csv_file, "complete", graph, MstAlgorithm::PrimDense, vertices >= 5000 ? long_options : options);
+            }
+        }
+        prim_simd_level = detected;
+    }
+
+    csv_file.close();
+    cout << "\nResults saved to mst_benchmark.csv\n";
 
     return 0;
 }
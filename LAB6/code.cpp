@@ -4,6 +4,29 @@
 #include <random>
 #include <algorithm>
 #include <fstream>
+#include <string>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#if defined(__unix__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define LAB6_X86_SIMD 1 // Векторные функции с target("avx2") и выбор пути во время выполнения
+#endif
 
 // Структура узла для BST и AVL-дерева
 struct Node {
@@ -11,90 +34,214 @@ struct Node {
     Node* left;        // Указатель на левое поддерево
     Node* right;       // Указатель на правое поддерево
     int height;        // Высота узла (используется в AVL для балансировки)
-    Node(int k) : key(k), left(nullptr), right(nullptr), height(1) {} // Конструктор узла
+    int size;          // Число узлов в поддереве (используется в AVL для порядковых запросов)
+    Node(int k) : key(k), left(nullptr), right(nullptr), height(1), size(1) {} // Конструктор узла
 };
 
-// Класс обычного бинарного дерева поиска (BST)
-class BST {
-private:
-    Node* root; // Корень дерева
+// Все операции над деревьями ниже итеративные: на отсортированных данных обычное BST
+// вырождается в список глубины n, и рекурсия переполнила бы стек уже на десятках тысяч ключей.
 
-    // Рекурсивная вставка ключа в BST
-    Node* insert(Node* node, int key) {
-        if (!node) return new Node(key); // Если узел пустой, создаём новый
-        if (key < node->key) node->left = insert(node->left, key); // Идём влево, если ключ меньше
-        else if (key > node->key) node->right = insert(node->right, key); // Идём вправо, если ключ больше
-        return node; // Дубликаты игнорируются
+// Узлы, выделенные одним куском при построении дерева из отсортированного массива.
+// Их нельзя удалять по одному: память освобождается вместе с блоком
+struct NodeBlock {
+    std::vector<Node> nodes;
+
+    bool owns(const Node* node) const {
+        std::less<const Node*> less;
+        return !nodes.empty() && !less(node, nodes.data()) && less(node, nodes.data() + nodes.size());
     }
 
-    // Рекурсивный поиск ключа в BST
-    Node* search(Node* node, int key) {
-        if (!node || node->key == key) return node; // Нашли ключ или дошли до конца
-        if (key < node->key) return search(node->left, key); // Ищем в левом поддереве
-        return search(node->right, key); // Ищем в правом поддереве
+    // Освобождает узел, если он был выделен отдельно через new
+    void release(Node* node) const {
+        if (!owns(node)) delete node;
     }
+};
 
-    // Поиск минимального узла (самый левый)
-    Node* findMin(Node* node) {
-        while (node->left) node = node->left; // Идём влево до конца
-        return node;
+// Строит идеально сбалансированное дерево из строго возрастающих ключей sorted[lo..hi).
+// Узлы кладутся в блок в прямом порядке (корень, левое, правое поддерево): левый потомок
+// лежит сразу за родителем. Глубина рекурсии — log n. Высоты и размеры поддеревьев выставляются для AVL.
+Node* buildBalanced(const std::vector<int>& sorted, int lo, int hi, NodeBlock& block) {
+    if (lo >= hi) return nullptr;
+    int mid = lo + (hi - lo) / 2;
+    Node* node = &block.nodes.emplace_back(sorted[mid]);
+    node->left = buildBalanced(sorted, lo, mid, block);
+    node->right = buildBalanced(sorted, mid + 1, hi, block);
+    node->height = 1 + std::max(node->left ? node->left->height : 0, node->right ? node->right->height : 0);
+    node->size = hi - lo;
+    return node;
+}
+
+// Очистка памяти дерева без рекурсии: левое поддерево поворотами переносится вправо,
+// так что всегда удаляется узел без левого потомка
+void destroyTree(Node* node, const NodeBlock& block) {
+    while (node) {
+        if (node->left) { // Правый поворот: левый потомок поднимается наверх
+            Node* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        } else {
+            Node* right = node->right;
+            block.release(node);
+            node = right;
+        }
     }
+}
 
-    // Рекурсивное удаление ключа из BST
-    Node* remove(Node* node, int key) {
-        if (!node) return nullptr; // Если узел пустой, ничего не делаем
-        if (key < node->key) node->left = remove(node->left, key); // Идём влево
-        else if (key > node->key) node->right = remove(node->right, key); // Идём вправо
-        else { // Нашли узел для удаления
-            if (!node->left) { // Случай 1: нет левого потомка
-                Node* temp = node->right;
-                delete node;
-                return temp;
-            }
-            else if (!node->right) { // Случай 2: нет правого потомка
-                Node* temp = node->left;
-                delete node;
-                return temp;
+// Общая часть build_from_sorted для BST и AVL: старое дерево удаляется, новое строится в новом блоке
+Node* rebuildFromSorted(Node* root, NodeBlock& block, const std::vector<int>& sorted) {
+    destroyTree(root, block);
+    block.nodes.clear();
+    block.nodes.shrink_to_fit();
+    block.nodes.reserve(sorted.size()); // Одно выделение памяти на всё дерево: указатели не будут перемещаться
+    return buildBalanced(sorted, 0, sorted.size(), block);
+}
+
+// Сортирует ключи и убирает повторы, чтобы построить дерево из произвольного массива
+std::vector<int> sortedUnique(std::vector<int> keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+// Высота дерева обходом в ширину по уровням
+int treeHeight(Node* root) {
+    if (!root) return 0;
+    std::vector<Node*> level = {root}, next;
+    int height = 0;
+    while (!level.empty()) {
+        height++;
+        next.clear();
+        for (Node* node : level) {
+            if (node->left) next.push_back(node->left);
+            if (node->right) next.push_back(node->right);
+        }
+        level.swap(next);
+    }
+    return height;
+}
+
+// Итеративный поиск ключа в дереве
+Node* findNode(Node* node, int key) {
+    while (node && node->key != key) node = key < node->key ? node->left : node->right; // Влево, если ключ меньше
+    return node;
+}
+
+// Подсказка процессору заранее загрузить кэш-линию с адресом ptr
+inline void prefetch(const void* ptr) {
+#ifdef __GNUC__
+    __builtin_prefetch(ptr);
+#else
+    (void)ptr;
+#endif
+}
+
+// Пакетный поиск: out[i] = есть ли keys[i] в дереве. Обычный поиск — цепочка зависимых
+// промахов кэша, по одному на уровень. Здесь группа из BATCH_GROUP поисков идёт по дереву
+// одновременно: за один проход каждый поиск делает шаг вниз и заранее запрашивает
+// следующий узел, так что промахи разных поисков перекрываются во времени
+const int BATCH_GROUP = 16;
+
+void searchBatchInTree(Node* root, const int* keys, size_t count, bool* out) {
+    Node* current[BATCH_GROUP];
+    for (size_t base = 0; base < count; base += BATCH_GROUP) {
+        int size = std::min<size_t>(BATCH_GROUP, count - base);
+        for (int j = 0; j < size; ++j) {
+            current[j] = root;
+            out[base + j] = false;
+        }
+        int active = root ? size : 0;
+        while (active > 0) {
+            active = 0;
+            for (int j = 0; j < size; ++j) {
+                Node* node = current[j];
+                if (!node) continue; // Этот поиск уже закончен
+                int key = keys[base + j];
+                if (node->key == key) {
+                    out[base + j] = true;
+                    current[j] = nullptr;
+                    continue;
+                }
+                node = key < node->key ? node->left : node->right;
+                current[j] = node;
+                if (node) {
+                    prefetch(node); // К следующему проходу узел уже будет в кэше
+                    active++;
+                }
             }
-            Node* temp = findMin(node->right); // Случай 3: есть оба потомка
-            node->key = temp->key; // Заменяем ключ минимальным из правого поддерева
-            node->right = remove(node->right, temp->key); // Удаляем минимальный
         }
-        return node;
     }
+}
 
-    // Очистка памяти дерева
-    void destroy(Node* node) {
-        if (node) {
-            destroy(node->left); // Рекурсивно чистим левое поддерево
-            destroy(node->right); // Рекурсивно чистим правое поддерево
-            delete node; // Удаляем текущий узел
+// Класс обычного бинарного дерева поиска (BST)
+class BST {
+private:
+    Node* root; // Корень дерева
+    NodeBlock block; // Узлы, построенные build_from_sorted
+
+    // Вставка ключа: спускаемся по ссылкам до пустого места
+    void insert(Node** link, int key) {
+        while (*link) {
+            if (key < (*link)->key) link = &(*link)->left; // Идём влево, если ключ меньше
+            else if (key > (*link)->key) link = &(*link)->right; // Идём вправо, если ключ больше
+            else return; // Дубликаты игнорируются
         }
+        *link = new Node(key); // Нашли пустое место, создаём новый узел
     }
 
-    // Рекурсивный метод для вычисления высоты узла
-    int height(Node* node) {
-        if (!node) return 0;
-        return 1 + std::max(height(node->left), height(node->right));
+    // Удаление ключа: link — ссылка на поддерево, в котором ищем
+    void remove(Node** link, int key) {
+        while (*link && (*link)->key != key) link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        Node* node = *link;
+        if (!node) return; // Ключа нет, ничего не делаем
+        if (!node->left) { // Случай 1: нет левого потомка
+            *link = node->right;
+            block.release(node);
+        }
+        else if (!node->right) { // Случай 2: нет правого потомка
+            *link = node->left;
+            block.release(node);
+        }
+        else { // Случай 3: есть оба потомка
+            Node** minLink = &node->right; // Ищем минимальный узел правого поддерева
+            while ((*minLink)->left) minLink = &(*minLink)->left;
+            Node* temp = *minLink;
+            node->key = temp->key; // Заменяем ключ минимальным из правого поддерева
+            *minLink = temp->right; // Удаляем минимальный (у него нет левого потомка)
+            block.release(temp);
+        }
     }
 
 public:
     BST() : root(nullptr) {} // Конструктор: пустое дерево
-    ~BST() { destroy(root); } // Деструктор: очищаем память
-    void insert(int key) { root = insert(root, key); } // Публичная вставка
-    bool search(int key) { return search(root, key) != nullptr; } // Публичный поиск
-    void remove(int key) { root = remove(root, key); } // Публичное удаление
-    int getHeight() { return height(root); } // Публичный метод для получения высоты дерева
+    ~BST() { destroyTree(root, block); } // Деструктор: очищаем память
+    void insert(int key) { insert(&root, key); } // Публичная вставка
+    bool search(int key) { return findNode(root, key) != nullptr; } // Публичный поиск
+    // Пакетный поиск count ключей с перекрытием промахов кэша (результаты в out)
+    void search_batch(const int* keys, size_t count, bool* out) { searchBatchInTree(root, keys, count, out); }
+    void remove(int key) { remove(&root, key); } // Публичное удаление
+    void clear() { root = rebuildFromSorted(root, block, {}); } // Удаление всех узлов
+    int getHeight() { return treeHeight(root); } // Публичный метод для получения высоты дерева
+
+    // Заменяет дерево идеально сбалансированным из строго возрастающих ключей за O(n)
+    void build_from_sorted(const std::vector<int>& sorted) { root = rebuildFromSorted(root, block, sorted); }
+    // То же для произвольного массива: сначала сортировка (O(n log n)), повторы отбрасываются
+    void build_from_unsorted(const std::vector<int>& keys) { build_from_sorted(sortedUnique(keys)); }
 };
 
 // Класс AVL-дерева (самобалансирующееся BST)
 class AVL {
 private:
     Node* root; // Корень дерева
+    NodeBlock block; // Узлы, построенные build_from_sorted
+    std::vector<Node**> path; // Ссылки на узлы пути от корня (для балансировки снизу вверх)
 
     // Получение высоты узла
     int getHeight(Node* node) { return node ? node->height : 0; }
 
+    // Число узлов в поддереве
+    static int getSize(const Node* node) { return node ? node->size : 0; }
+
     // Вычисление фактора баланса
     int getBalance(Node* node) { return node ? getHeight(node->left) - getHeight(node->right) : 0; }
 
@@ -106,6 +253,8 @@ private:
         y->left = T2; // T2 становится левым потомком y
         y->height = std::max(getHeight(y->left), getHeight(y->right)) + 1; // Обновляем высоту y
         x->height = std::max(getHeight(x->left), getHeight(x->right)) + 1; // Обновляем высоту x
+        y->size = getSize(y->left) + getSize(y->right) + 1; // И размеры поддеревьев: сначала нижний узел
+        x->size = getSize(x->left) + getSize(x->right) + 1;
         return x; // Новый корень
     }
 
@@ -117,115 +266,1158 @@ private:
         x->right = T2; // T2 становится правым потомком x
         x->height = std::max(getHeight(x->left), getHeight(x->right)) + 1; // Обновляем высоту x
         y->height = std::max(getHeight(y->left), getHeight(y->right)) + 1; // Обновляем высоту y
+        x->size = getSize(x->left) + getSize(x->right) + 1; // И размеры поддеревьев: сначала нижний узел
+        y->size = getSize(y->left) + getSize(y->right) + 1;
         return y; // Новый корень
     }
 
-    // Рекурсивная вставка в AVL
-    Node* insert(Node* node, int key) {
-        if (!node) return new Node(key); // Создаём новый узел, если пусто
-        if (key < node->key) node->left = insert(node->left, key); // Идём влево
-        else if (key > node->key) node->right = insert(node->right, key); // Идём вправо
-        else return node; // Дубликаты игнорируются
-
+    // Обновляет высоту и размер узла и при необходимости делает поворот; возвращает новый корень поддерева
+    Node* rebalance(Node* node) {
         node->height = std::max(getHeight(node->left), getHeight(node->right)) + 1; // Обновляем высоту
+        node->size = getSize(node->left) + getSize(node->right) + 1;
         int balance = getBalance(node); // Проверяем баланс
 
         // Балансировка: 4 случая
-        if (balance > 1 && key < node->left->key) return rightRotate(node); // Левый-левый
-        if (balance < -1 && key > node->right->key) return leftRotate(node); // Правый-правый
-        if (balance > 1 && key > node->left->key) { // Левый-правый
+        if (balance > 1 && getBalance(node->left) >= 0) return rightRotate(node); // Левый-левый
+        if (balance > 1) { // Левый-правый
             node->left = leftRotate(node->left);
             return rightRotate(node);
         }
-        if (balance < -1 && key < node->right->key) { // Правый-левый
+        if (balance < -1 && getBalance(node->right) <= 0) return leftRotate(node); // Правый-правый
+        if (balance < -1) { // Правый-левый
             node->right = rightRotate(node->right);
             return leftRotate(node);
         }
         return node;
     }
 
-    // Рекурсивный поиск в AVL
-    Node* search(Node* node, int key) {
-        if (!node || node->key == key) return node;
-        if (key < node->key) return search(node->left, key);
-        return search(node->right, key);
+    // Проходит путь снизу вверх, обновляя высоты и балансируя узлы.
+    // Если высота поддерева не изменилась, выше тоже ничего не меняется — останавливаемся
+    void rebalancePath() {
+        while (!path.empty()) {
+            Node** link = path.back();
+            path.pop_back();
+            int oldHeight = (*link)->height;
+            Node* oldRoot = *link;
+            *link = rebalance(*link);
+            if (*link == oldRoot && (*link)->height == oldHeight) break;
+        }
+        path.clear();
     }
 
-    // Поиск минимального узла
-    Node* findMin(Node* node) {
-        while (node->left) node = node->left;
-        return node;
+public:
+    AVL() : root(nullptr) {} // Конструктор
+    ~AVL() { destroyTree(root, block); } // Деструктор
+
+    // Обход ключей по возрастанию без рекурсии. В стеке лежат ещё не выданные узлы, чьи левые
+    // поддеревья уже пройдены; наверху — текущий. Любое изменение дерева делает итератор недействительным
+    class Iterator {
+        Node* stack[64]; // Высота AVL-дерева из менее чем 2^31 узлов не больше 45
+        int depth = 0;
+        friend class AVL;
+
+        void pushLeft(Node* node) {
+            for (; node; node = node->left) stack[depth++] = node;
+        }
+
+    public:
+        int operator*() const { return stack[depth - 1]->key; }
+        Iterator& operator++() { // Следующий ключ: самый левый узел правого поддерева или ближайший предок
+            Node* node = stack[--depth];
+            pushLeft(node->right);
+            return *this;
+        }
+        bool operator==(const Iterator& other) const {
+            return depth == other.depth && (depth == 0 || stack[depth - 1] == other.stack[depth - 1]);
+        }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    // Вставка: спуск с запоминанием пути, затем балансировка снизу вверх
+    void insert(int key) {
+        path.clear();
+        Node** link = &root;
+        while (*link) {
+            if (key == (*link)->key) return; // Дубликаты игнорируются
+            path.push_back(link);
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        *link = new Node(key); // Создаём новый узел на пустом месте
+        // Размер растёт у всех предков, а не только до места, где остановится балансировка
+        for (Node** ancestor : path) (*ancestor)->size++;
+        rebalancePath();
     }
 
-    // Рекурсивное удаление в AVL
-    Node* remove(Node* node, int key) {
-        if (!node) return nullptr;
-        if (key < node->key) node->left = remove(node->left, key);
-        else if (key > node->key) node->right = remove(node->right, key);
+    bool search(int key) { return findNode(root, key) != nullptr; } // Публичный поиск
+    // Пакетный поиск count ключей с перекрытием промахов кэша (результаты в out)
+    void search_batch(const int* keys, size_t count, bool* out) { searchBatchInTree(root, keys, count, out); }
+
+    // Удаление: как в BST, но весь путь до удалённого узла затем балансируется
+    void remove(int key) {
+        path.clear();
+        Node** link = &root;
+        while (*link && (*link)->key != key) {
+            path.push_back(link);
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        Node* node = *link;
+        if (!node) { // Ключа нет
+            path.clear();
+            return;
+        }
+        if (!node->left || !node->right) { // Не больше одного потомка: он занимает место узла
+            *link = node->left ? node->left : node->right;
+            block.release(node);
+        } else { // Оба потомка: ключ заменяется минимальным из правого поддерева
+            path.push_back(link);
+            Node** minLink = &node->right;
+            while ((*minLink)->left) {
+                path.push_back(minLink);
+                minLink = &(*minLink)->left;
+            }
+            Node* temp = *minLink;
+            node->key = temp->key;
+            *minLink = temp->right;
+            block.release(temp);
+        }
+        // После удаления высоты могут меняться до самого корня: останавливаться раньше нельзя
+        while (!path.empty()) {
+            Node** parentLink = path.back();
+            path.pop_back();
+            *parentLink = rebalance(*parentLink);
+        }
+    }
+
+    void clear() { root = rebuildFromSorted(root, block, {}); } // Удаление всех узлов
+    int getHeight() { return treeHeight(root); } // Публичный метод для получения высоты дерева
+    int getSize() const { return getSize(root); } // Число ключей в дереве
+
+    // Порядковые запросы за O(log n) по размерам поддеревьев.
+    // Число ключей меньше key (при inclusive — не больше key)
+    int countLess(int key, bool inclusive) const {
+        int count = 0;
+        Node* node = root;
+        while (node) {
+            if (key < node->key || (key == node->key && !inclusive)) {
+                node = node->left;
+            } else { // Узел и всё его левое поддерево не больше key
+                count += getSize(node->left) + 1;
+                node = node->right;
+            }
+        }
+        return count;
+    }
+
+    int rank(int key) const { return countLess(key, false); } // Позиция key среди ключей по возрастанию
+
+    // k-й по возрастанию ключ (с нуля) в key; false, если ключей не больше k
+    bool select(int k, int& key) const {
+        if (k < 0 || k >= getSize(root)) return false;
+        Node* node = root;
+        while (true) {
+            int leftSize = getSize(node->left);
+            if (k == leftSize) {
+                key = node->key;
+                return true;
+            }
+            if (k < leftSize) {
+                node = node->left;
+            } else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+    }
+
+    // Число ключей в отрезке [lo, hi]
+    int count_range(int lo, int hi) const { return lo > hi ? 0 : countLess(hi, true) - countLess(lo, false); }
+
+    Iterator begin() const {
+        Iterator it;
+        it.pushLeft(root);
+        return it;
+    }
+    Iterator end() const { return Iterator(); }
+
+    // Итератор на первый ключ, не меньший key: в стек попадают узлы, от которых спуск ушёл влево
+    Iterator lower_bound(int key) const {
+        Iterator it;
+        for (Node* node = root; node;) {
+            if (node->key < key) {
+                node = node->right;
+            } else {
+                it.stack[it.depth++] = node;
+                node = node->left;
+            }
+        }
+        return it;
+    }
+
+    // Заменяет дерево идеально сбалансированным из строго возрастающих ключей за O(n).
+    // Высоты и размеры узлов выставлены, поэтому дальнейшие insert/remove балансируют его как обычно
+    void build_from_sorted(const std::vector<int>& sorted) { root = rebuildFromSorted(root, block, sorted); }
+    // То же для произвольного массива: сначала сортировка (O(n log n)), повторы отбрасываются
+    void build_from_unsorted(const std::vector<int>& keys) { build_from_sorted(sortedUnique(keys)); }
+};
+
+// Узел AVL-дерева в пуле: вместо указателей 32-битные номера узлов в общем массиве
+// (0 — нет узла). 16 байт вместо 32: четыре узла ровно в одной кэш-линии
+struct PooledNode {
+    int key;
+    uint32_t left;   // Номер левого потомка
+    uint32_t right;  // Номер правого потомка
+    int height;
+};
+
+// AVL-дерево, все узлы которого лежат в одном непрерывном массиве.
+// Освобождённые узлы не возвращаются системе, а образуют список свободных (через left)
+// и переиспользуются при следующих вставках; удаление всего дерева — одно освобождение массива
+class PooledAVL {
+private:
+    std::vector<PooledNode> pool = std::vector<PooledNode>(1); // Узел 0 — заглушка "нет узла"
+    uint32_t root = 0;
+    uint32_t freeList = 0;                        // Первый свободный узел
+    std::vector<std::pair<uint32_t, bool>> path;  // Узлы пути от корня и направление (true — влево)
+
+    int getHeight(uint32_t i) const { return i ? pool[i].height : 0; }
+    int getBalance(uint32_t i) const { return getHeight(pool[i].left) - getHeight(pool[i].right); }
+    void updateHeight(uint32_t i) { pool[i].height = std::max(getHeight(pool[i].left), getHeight(pool[i].right)) + 1; }
+
+    uint32_t allocate(int key) {
+        uint32_t i = freeList;
+        if (i) freeList = pool[i].left;
         else {
-            if (!node->left) {
-                Node* temp = node->right;
-                delete node;
-                return temp;
+            i = pool.size();
+            pool.emplace_back();
+        }
+        pool[i].key = key;
+        pool[i].left = 0;
+        pool[i].right = 0;
+        pool[i].height = 1;
+        return i;
+    }
+
+    void release(uint32_t i) {
+        pool[i].left = freeList;
+        freeList = i;
+    }
+
+    // Правый поворот для балансировки
+    uint32_t rightRotate(uint32_t y) {
+        uint32_t x = pool[y].left; // Левый потомок становится новым корнем
+        pool[y].left = pool[x].right;
+        pool[x].right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    // Левый поворот для балансировки
+    uint32_t leftRotate(uint32_t x) {
+        uint32_t y = pool[x].right; // Правый потомок становится новым корнем
+        pool[x].right = pool[y].left;
+        pool[y].left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    // Обновляет высоту узла и при необходимости делает поворот; возвращает новый корень поддерева
+    uint32_t rebalance(uint32_t i) {
+        updateHeight(i);
+        int balance = getBalance(i);
+        if (balance > 1) {
+            if (getBalance(pool[i].left) < 0) pool[i].left = leftRotate(pool[i].left); // Левый-правый
+            return rightRotate(i);
+        }
+        if (balance < -1) {
+            if (getBalance(pool[i].right) > 0) pool[i].right = rightRotate(pool[i].right); // Правый-левый
+            return leftRotate(i);
+        }
+        return i;
+    }
+
+    // Подвешивает child под последний узел пути и балансирует путь снизу вверх
+    void rebalancePath(uint32_t child) {
+        while (!path.empty()) {
+            auto [parent, wentLeft] = path.back();
+            path.pop_back();
+            if (wentLeft) pool[parent].left = child;
+            else pool[parent].right = child;
+            int oldHeight = pool[parent].height;
+            child = rebalance(parent);
+            if (child == parent && pool[parent].height == oldHeight) { // Выше ничего не меняется
+                path.clear();
+                return;
             }
-            else if (!node->right) {
-                Node* temp = node->left;
-                delete node;
-                return temp;
+        }
+        root = child;
+    }
+
+public:
+    void insert(int key) {
+        path.clear();
+        uint32_t current = root;
+        while (current) {
+            if (key == pool[current].key) return; // Дубликаты игнорируются
+            bool goLeft = key < pool[current].key;
+            path.emplace_back(current, goLeft);
+            current = goLeft ? pool[current].left : pool[current].right;
+        }
+        rebalancePath(allocate(key));
+    }
+
+    // Выбор потомка — без ветвления: направление спуска случайно, и переход по сравнению
+    // предсказывался бы неверно примерно на каждом втором уровне
+    bool search(int key) {
+        uint32_t current = root;
+        while (current) {
+            const PooledNode& node = pool[current];
+            if (node.key == key) return true;
+            current = key < node.key ? node.left : node.right; // Компилируется в cmov
+        }
+        return false;
+    }
+
+    void remove(int key) {
+        path.clear();
+        uint32_t current = root;
+        while (current && pool[current].key != key) {
+            bool goLeft = key < pool[current].key;
+            path.emplace_back(current, goLeft);
+            current = goLeft ? pool[current].left : pool[current].right;
+        }
+        if (!current) { // Ключа нет
+            path.clear();
+            return;
+        }
+        uint32_t replacement;
+        if (!pool[current].left || !pool[current].right) { // Не больше одного потомка: он занимает место узла
+            replacement = pool[current].left ? pool[current].left : pool[current].right;
+            release(current);
+        } else { // Оба потомка: ключ заменяется минимальным из правого поддерева
+            path.emplace_back(current, false);
+            uint32_t minNode = pool[current].right;
+            while (pool[minNode].left) {
+                path.emplace_back(minNode, true);
+                minNode = pool[minNode].left;
             }
-            Node* temp = findMin(node->right);
-            node->key = temp->key;
-            node->right = remove(node->right, temp->key);
+            pool[current].key = pool[minNode].key;
+            replacement = pool[minNode].right;
+            release(minNode);
+        }
+        // После удаления высоты могут меняться до самого корня
+        while (!path.empty()) {
+            auto [parent, wentLeft] = path.back();
+            path.pop_back();
+            if (wentLeft) pool[parent].left = replacement;
+            else pool[parent].right = replacement;
+            replacement = rebalance(parent);
         }
-        if (!node) return node;
+        root = replacement;
+    }
 
-        node->height = std::max(getHeight(node->left), getHeight(node->right)) + 1; // Обновляем высоту
-        int balance = getBalance(node); // Проверяем баланс
+    // Удаляет все узлы: массив освобождается целиком
+    void clear() {
+        std::vector<PooledNode>(1).swap(pool);
+        root = freeList = 0;
+    }
 
-        // Балансировка после удаления
-        if (balance > 1 && getBalance(node->left) >= 0) return rightRotate(node);
-        if (balance > 1 && getBalance(node->left) < 0) {
-            node->left = leftRotate(node->left);
+    int getHeight() { return getHeight(root); }
+
+    // Сколько байт занимает пул узлов
+    size_t memoryBytes() const { return pool.capacity() * sizeof(PooledNode); }
+};
+
+// AVL-дерево для многих потоков по схеме RCU (read-copy-update): опубликованные узлы никогда
+// не меняются. Писатель (один за раз, под мьютексом) копирует путь от корня до места изменения
+// вместе с узлами поворотов и одной атомарной записью публикует новый корень. Читатели не берут
+// блокировок и видят либо старую, либо новую версию дерева целиком.
+// Заменённые узлы освобождаются по эпохам: только когда ни один читатель, начавший поиск
+// до публикации, уже не может на них смотреть.
+// Рекурсия здесь допустима: высота AVL-дерева логарифмическая
+class ConcurrentAVL {
+public:
+    static constexpr int MAX_READERS = 64; // Сколько потоков могут искать одновременно
+
+private:
+    struct CNode {
+        int key;
+        int height;
+        CNode* left;
+        CNode* right;
+        uint64_t version; // Номер записи, создавшей узел: узлы текущей записи ещё не видны читателям
+    };
+
+    // Эпоха, в которой читатель начал поиск (0 — не ищет). Каждая в своей кэш-линии,
+    // чтобы отметки разных потоков не вытесняли друг у друга линию
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+    };
+
+    std::atomic<CNode*> root{nullptr};
+    std::atomic<uint64_t> epoch{1}; // Растёт с каждой публикацией
+    ReaderSlot readers[MAX_READERS];
+    std::mutex writeMutex; // Писатели по очереди
+    uint64_t writeVersion = 0;
+    std::vector<CNode*> retired; // Узлы, заменённые текущей записью
+    std::vector<std::pair<uint64_t, CNode*>> garbage; // Заменённые узлы с эпохой замены, по возрастанию эпох
+
+    static int getHeight(const CNode* node) { return node ? node->height : 0; }
+    static int getBalance(const CNode* node) { return getHeight(node->left) - getHeight(node->right); }
+    static void updateHeight(CNode* node) { node->height = std::max(getHeight(node->left), getHeight(node->right)) + 1; }
+
+    // Узел, который текущая запись может менять: свой или копия опубликованного (он уходит в retired)
+    CNode* own(CNode* node) {
+        if (node->version == writeVersion) return node;
+        retired.push_back(node);
+        CNode* copy = new CNode(*node);
+        copy->version = writeVersion;
+        return copy;
+    }
+
+    // Узел удаляется из дерева: свой освобождается сразу, опубликованный — после читателей
+    void retire(CNode* node) {
+        if (node->version == writeVersion) delete node;
+        else retired.push_back(node);
+    }
+
+    // Повороты и балансировка как в AVL, но над своими узлами (y и x уже получены через own)
+    CNode* rightRotate(CNode* y) {
+        CNode* x = own(y->left);
+        y->left = x->right;
+        x->right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    CNode* leftRotate(CNode* x) {
+        CNode* y = own(x->right);
+        x->right = y->left;
+        y->left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    CNode* rebalance(CNode* node) {
+        updateHeight(node);
+        int balance = getBalance(node);
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) node->left = leftRotate(own(node->left)); // Левый-правый
             return rightRotate(node);
         }
-        if (balance < -1 && getBalance(node->right) <= 0) return leftRotate(node);
-        if (balance < -1 && getBalance(node->right) > 0) {
-            node->right = rightRotate(node->right);
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) node->right = rightRotate(own(node->right)); // Правый-левый
             return leftRotate(node);
         }
         return node;
     }
 
-    // Очистка памяти дерева
-    void destroy(Node* node) {
-        if (node) {
-            destroy(node->left);
-            destroy(node->right);
-            delete node;
+    // Вставка в поддерево; changed — появился ли новый ключ (иначе копировать нечего)
+    CNode* insertAt(CNode* node, int key, bool& changed) {
+        if (!node) {
+            changed = true;
+            return new CNode{key, 1, nullptr, nullptr, writeVersion};
+        }
+        if (key == node->key) return node; // Дубликаты игнорируются
+        CNode* child = insertAt(key < node->key ? node->left : node->right, key, changed);
+        if (!changed) return node;
+        node = own(node);
+        (key < node->key ? node->left : node->right) = child;
+        return rebalance(node);
+    }
+
+    // Отрезает минимальный узел поддерева, его ключ — в minKey
+    CNode* removeMin(CNode* node, int& minKey) {
+        if (!node->left) {
+            minKey = node->key;
+            CNode* right = node->right;
+            retire(node);
+            return right;
+        }
+        CNode* left = removeMin(node->left, minKey);
+        node = own(node);
+        node->left = left;
+        return rebalance(node);
+    }
+
+    CNode* removeAt(CNode* node, int key, bool& changed) {
+        if (!node) return nullptr;
+        if (key != node->key) {
+            CNode* child = removeAt(key < node->key ? node->left : node->right, key, changed);
+            if (!changed) return node;
+            node = own(node);
+            (key < node->key ? node->left : node->right) = child;
+            return rebalance(node);
+        }
+        changed = true;
+        if (!node->left || !node->right) { // Не больше одного потомка: он занимает место узла
+            CNode* child = node->left ? node->left : node->right;
+            retire(node);
+            return child;
+        }
+        int minKey; // Оба потомка: ключ заменяется минимальным из правого поддерева
+        CNode* right = removeMin(node->right, minKey);
+        node = own(node);
+        node->key = minKey;
+        node->right = right;
+        return rebalance(node);
+    }
+
+    // Публикует новую версию и освобождает узлы, которые уже никто не читает.
+    // Читатель, державший старый корень, отметился эпохой не новее текущей: её узлы
+    // можно удалить, только когда все отмеченные читатели начали поиск позже
+    void publish(CNode* newRoot) {
+        root.store(newRoot);
+        uint64_t current = epoch.load(std::memory_order_relaxed);
+        for (CNode* node : retired) garbage.emplace_back(current, node);
+        retired.clear();
+        epoch.store(current + 1);
+
+        uint64_t oldest = UINT64_MAX; // Самая ранняя эпоха среди читателей, которые сейчас ищут
+        for (ReaderSlot& reader : readers) {
+            uint64_t e = reader.epoch.load();
+            if (e && e < oldest) oldest = e;
         }
+        size_t freed = 0;
+        while (freed < garbage.size() && garbage[freed].first < oldest) delete garbage[freed++].second;
+        garbage.erase(garbage.begin(), garbage.begin() + freed);
     }
 
-    // Рекурсивный метод для вычисления высоты узла
-    int height(Node* node) {
-        if (!node) return 0;
-        return 1 + std::max(height(node->left), height(node->right));
+    static void destroy(CNode* node) {
+        if (!node) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
     }
 
 public:
-    AVL() : root(nullptr) {} // Конструктор
-    ~AVL() { destroy(root); } // Деструктор
-    void insert(int key) { root = insert(root, key); } // Публичная вставка
-    bool search(int key) { return search(root, key) != nullptr; } // Публичный поиск
-    void remove(int key) { root = remove(root, key); } // Публичное удаление
-    int getHeight() { return height(root); } // Публичный метод для получения высоты дерева
+    ConcurrentAVL() = default;
+    ConcurrentAVL(const ConcurrentAVL&) = delete;
+    ConcurrentAVL& operator=(const ConcurrentAVL&) = delete;
+    ~ConcurrentAVL() { // Вызывается, когда читателей уже нет
+        destroy(root.load());
+        for (auto& entry : garbage) delete entry.second;
+    }
+
+    void insert(int key) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        ++writeVersion;
+        bool changed = false;
+        CNode* newRoot = insertAt(root.load(std::memory_order_relaxed), key, changed);
+        if (changed) publish(newRoot);
+    }
+
+    void remove(int key) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        ++writeVersion;
+        bool changed = false;
+        CNode* newRoot = removeAt(root.load(std::memory_order_relaxed), key, changed);
+        if (changed) publish(newRoot);
+    }
+
+    // Поиск без блокировок; reader — номер потока (меньше MAX_READERS), у каждого потока свой.
+    // Отметка ставится до чтения корня: писатель либо увидит её, либо читатель увидит новый корень
+    bool search(int key, int reader) {
+        std::atomic<uint64_t>& mark = readers[reader].epoch;
+        mark.store(epoch.load());
+        const CNode* node = root.load();
+        while (node && node->key != key) node = key < node->key ? node->left : node->right;
+        mark.store(0, std::memory_order_release); // Все чтения узлов завершены до снятия отметки
+        return node != nullptr;
+    }
+
+    int getHeight() const { return getHeight(root.load()); }
+};
+
+// Обычное AVL под одним замком — базовая линия для ConcurrentAVL. С std::shared_mutex
+// поиски идут параллельно под общей блокировкой, с std::mutex всё строго по очереди
+template <typename Mutex>
+class LockedAVL {
+private:
+    AVL tree;
+    Mutex mutex;
+
+public:
+    void insert(int key) {
+        std::lock_guard<Mutex> lock(mutex);
+        tree.insert(key);
+    }
+
+    void remove(int key) {
+        std::lock_guard<Mutex> lock(mutex);
+        tree.remove(key);
+    }
+
+    bool search(int key, int) { // Поиск ничего не меняет в дереве, поэтому общей блокировки достаточно
+        if constexpr (std::is_same_v<Mutex, std::shared_mutex>) {
+            std::shared_lock<Mutex> lock(mutex);
+            return tree.search(key);
+        } else {
+            std::lock_guard<Mutex> lock(mutex);
+            return tree.search(key);
+        }
+    }
+};
+
+// Способ раскладки неизменяемого дерева поиска в массиве
+enum class StaticLayout {
+    Eytzinger,   // Порядок обхода в ширину: потомки узла k лежат в 2k и 2k+1
+    VanEmdeBoas  // Рекурсивная раскладка: верхнее поддерево, затем нижние, каждое непрерывным блоком
+};
+
+// Неизменяемое дерево поиска в массиве, построенное по отсортированным ключам.
+// Указателей нет: потомки вычисляются по индексу, поэтому узел занимает 4 байта,
+// а спуск по дереву идёт без ветвлений (сравнение превращается в сдвиг индекса).
+class StaticSearchTree {
+private:
+    StaticLayout layout;
+    int height = 0;              // Число уровней полного дерева
+    std::vector<int> storage;    // Память с запасом для выравнивания на кэш-линию
+    int* data = nullptr;         // Узлы дерева (Eytzinger — с индекса 1, vEB — с индекса 0)
+    bool hasMaxKey = false;      // Есть ли среди ключей INT_MAX (им же заполнен хвост дерева)
+
+    // Таблицы для раскладки vEB (по глубине узла d, см. Brodal, Fagerberg, Jacob):
+    // узел на глубине d — корень одного из нижних поддеревьев в разбиении, которое начинается
+    // на глубине topDepth[d]; верхнее поддерево там занимает topSize[d] узлов, каждое нижнее — bottomSize[d].
+    std::vector<int> topDepth, topSize, bottomSize;
+
+    // Заполняет таблицы vEB для поддерева высоты h, корень которого на глубине depth
+    void splitVeb(int depth, int h) {
+        if (h <= 1) return;
+        int topHeight = h / 2, bottomHeight = h - topHeight;
+        int d = depth + topHeight;
+        topDepth[d] = depth;
+        topSize[d] = (1 << topHeight) - 1;
+        bottomSize[d] = (1 << bottomHeight) - 1;
+        splitVeb(depth, topHeight);
+        splitVeb(d, bottomHeight);
+    }
+
+    // Позиция в массиве vEB узла с номером i (нумерация обхода в ширину) на глубине d,
+    // если известны позиции его предков pos[0..d-1]
+    int vebPosition(const int* pos, int d, unsigned i) const {
+        return pos[topDepth[d]] + topSize[d] + int(i & unsigned(topSize[d])) * bottomSize[d];
+    }
+
+    // Раскладывает отсортированные ключи по порядку Eytzinger: in-order обход неявного дерева
+    static void fillEytzinger(const std::vector<int>& sorted, int* out, int size) {
+        std::vector<int> stack; // Итеративный in-order обход: номера узлов на пути
+        size_t next = 0;
+        int k = 1;
+        while (k <= size || !stack.empty()) {
+            while (k <= size) {
+                stack.push_back(k);
+                k = 2 * k;
+            }
+            k = stack.back();
+            stack.pop_back();
+            out[k] = next < sorted.size() ? sorted[next] : INT_MAX; // Хвост полного дерева — "бесконечность"
+            next++;
+            k = 2 * k + 1;
+        }
+    }
+
+public:
+    StaticSearchTree(const std::vector<int>& sorted, StaticLayout layoutType) : layout(layoutType) {
+        int n = sorted.size();
+        while ((1 << height) - 1 < n) height++;
+        int size = (1 << height) - 1; // Дерево дополняется до полного
+        hasMaxKey = n > 0 && sorted.back() == INT_MAX;
+
+        const int lineInts = 64 / sizeof(int);
+        storage.assign(size + 1 + lineInts, INT_MAX);
+        size_t misalignment = reinterpret_cast<std::uintptr_t>(storage.data()) % 64 / sizeof(int);
+        data = storage.data() + (misalignment ? lineInts - misalignment : 0);
+
+        if (layout == StaticLayout::Eytzinger) {
+            fillEytzinger(sorted, data, size);
+            return;
+        }
+
+        // vEB: раскладываем ключи в порядке обхода в ширину, затем переносим каждый узел на его позицию
+        std::vector<int> bfs(size + 1);
+        fillEytzinger(sorted, bfs.data(), size);
+        topDepth.assign(height + 1, 0);
+        topSize.assign(height + 1, 0);
+        bottomSize.assign(height + 1, 0);
+        splitVeb(0, height);
+        std::vector<int> position(size + 1, 0); // Позиция узла по номеру обхода в ширину
+        for (int i = 2, d = 1; i <= size; ++i) {
+            if (i == (1 << (d + 1))) d++;
+            int ancestor = i >> (d - topDepth[d]);
+            position[i] = position[ancestor] + topSize[d] + (i & topSize[d]) * bottomSize[d];
+        }
+        for (int i = 1; i <= size; ++i) data[position[i]] = bfs[i];
+    }
+
+    StaticSearchTree(const StaticSearchTree&) = delete;
+    StaticSearchTree& operator=(const StaticSearchTree&) = delete;
+
+    // Поиск ключа. Спуск всегда проходит все уровни: ветвлений, зависящих от данных, нет
+    bool search(int key) const {
+        if (height == 0) return false;
+        if (key == INT_MAX) return hasMaxKey;
+        if (layout == StaticLayout::Eytzinger) {
+            unsigned k = 1;
+            while (k <= unsigned((1 << height) - 1)) {
+                prefetch(data + 16 * k); // Потомки на 4 уровня ниже лежат в одной кэш-линии
+                k = 2 * k + (data[k] < key);
+            }
+            k >>= __builtin_ffs(~k); // Убираем хвост из "правых" шагов: получаем первый узел с data[k] >= key
+            return k != 0 && data[k] == key;
+        }
+
+        int pos[32];
+        pos[0] = 0;
+        unsigned i = 1;
+        int candidate = INT_MAX; // Наименьший встреченный ключ >= key
+        for (int d = 0; d < height; ++d) {
+            int value = data[pos[d]];
+            candidate = value >= key ? value : candidate; // По пути вниз такие ключи только убывают
+            i = 2 * i + (value < key);
+            if (d + 1 < height) pos[d + 1] = vebPosition(pos, d + 1, i);
+        }
+        return candidate == key;
+    }
+};
+
+// Поддерживает ли процессор AVX2. AVX2-функции собираются с target("avx2") и выбираются
+// во время выполнения, поэтому и сборка без -mavx2 сравнивает по 8 ключей, если процессор умеет
+bool detectAvx2() {
+#ifdef LAB6_X86_SIMD
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+const bool hasAvx2 = detectAvx2();
+
+// Какой путь выбран для векторного поиска в массиве и узлах B+ дерева (для вывода рядом с результатами)
+const char* simdPathName() {
+    if (hasAvx2) return "AVX2, 8 keys per compare";
+#if defined(__SSE2__)
+    return "SSE2, 4 keys per compare";
+#else
+    return "scalar";
+#endif
+}
+
+#ifdef LAB6_X86_SIMD
+template <int Cap, bool Greater>
+__attribute__((target("avx2"))) int countComparedAvx2(const int* keys, int key) {
+    int result = 0;
+    __m256i k = _mm256_set1_epi32(key);
+    for (int i = 0; i < Cap; i += 8) {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i mask = Greater ? _mm256_cmpgt_epi32(v, k) : _mm256_cmpgt_epi32(k, v);
+        result += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+    }
+    return result;
+}
+#endif
+
+// Сколько ключей в массиве из Cap элементов меньше (Greater = false) или больше (Greater = true) key.
+// Массив выровнен на 32 байта; незанятый хвост узла заполнен INT_MAX, поэтому сравнивать можно
+// весь массив целиком, без ветвлений: 8 (AVX2, если есть у процессора) или 4 (SSE2) ключа за одно сравнение
+template <int Cap, bool Greater>
+inline int countCompared(const int* keys, int key) {
+#ifdef LAB6_X86_SIMD
+    if (hasAvx2) return countComparedAvx2<Cap, Greater>(keys, key);
+#endif
+    int result = 0;
+#if defined(__SSE2__)
+    __m128i k = _mm_set1_epi32(key);
+    for (int i = 0; i < Cap; i += 4) {
+        __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i));
+        __m128i mask = Greater ? _mm_cmpgt_epi32(v, k) : _mm_cmplt_epi32(v, k);
+        result += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    }
+#else
+    for (int i = 0; i < Cap; ++i) result += Greater ? keys[i] > key : keys[i] < key;
+#endif
+    return result;
+}
+
+// Способ поиска ключа в плоском массиве
+enum class ArraySearchMode {
+    Find,          // std::find по неотсортированному массиву
+    SimdLinear,    // Векторный линейный поиск по неотсортированному массиву
+    Branchless,    // Двоичный поиск без ветвлений по отсортированному массиву
+    Interpolation  // Интерполяционный поиск по отсортированному массиву
 };
 
-// Генерация случайного массива с уникальными значениями
-std::vector<int> generateRandomArray(int size) {
+#ifdef LAB6_X86_SIMD
+// Линейный поиск на AVX2: четыре вектора по 8 ключей сравниваются подряд и проверяются одним переходом
+__attribute__((target("avx2"))) bool linearSearchAvx2(const int* data, size_t n, int key) {
+    size_t i = 0;
+    __m256i k = _mm256_set1_epi32(key);
+    for (; i + 32 <= n; i += 32) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(data + i);
+        __m256i a = _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(block), k),
+                                    _mm256_cmpeq_epi32(_mm256_loadu_si256(block + 1), k));
+        __m256i b = _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(block + 2), k),
+                                    _mm256_cmpeq_epi32(_mm256_loadu_si256(block + 3), k));
+        __m256i any = _mm256_or_si256(a, b);
+        if (!_mm256_testz_si256(any, any)) return true;
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), k);
+        if (!_mm256_testz_si256(eq, eq)) return true;
+    }
+    for (; i < n; ++i) { // Хвост короче вектора
+        if (data[i] == key) return true;
+    }
+    return false;
+}
+#endif
+
+// Линейный поиск: 8 (AVX2, если есть у процессора) или 4 (SSE2) ключа за одно сравнение.
+// Четыре вектора сравниваются подряд и проверяются одним переходом, выход — на первом блоке с совпадением
+inline bool linearSearch(const int* data, size_t n, int key) {
+#ifdef LAB6_X86_SIMD
+    if (hasAvx2) return linearSearchAvx2(data, n, key);
+#endif
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i k = _mm_set1_epi32(key);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(data + i);
+        __m128i a = _mm_or_si128(_mm_cmpeq_epi32(_mm_loadu_si128(block), k), _mm_cmpeq_epi32(_mm_loadu_si128(block + 1), k));
+        __m128i b = _mm_or_si128(_mm_cmpeq_epi32(_mm_loadu_si128(block + 2), k), _mm_cmpeq_epi32(_mm_loadu_si128(block + 3), k));
+        if (_mm_movemask_epi8(_mm_or_si128(a, b))) return true;
+    }
+#endif
+    for (; i < n; ++i) { // Хвост короче блока
+        if (data[i] == key) return true;
+    }
+    return false;
+}
+
+// Двоичный поиск без ветвлений по отсортированному массиву: половина отрезка отбрасывается
+// условной пересылкой, поэтому нет неверно предсказанных переходов. Обе середины, которые
+// могут понадобиться на следующем шаге, заранее запрашиваются в кэш
+inline bool branchlessSearch(const int* data, size_t n, int key) {
+    if (n == 0) return false;
+    const int* base = data;
+    while (n > 1) {
+        size_t half = n / 2;
+        size_t nextHalf = (n - half) / 2;
+        prefetch(base + nextHalf);
+        prefetch(base + half + nextHalf);
+        base = base[half] <= key ? base + half : base; // Компилируется в cmov
+        n -= half;
+    }
+    return *base == key;
+}
+
+// Интерполяционный поиск по отсортированному массиву: позиция ключа оценивается по значениям
+// на концах отрезка. На равномерно распределённых ключах хватает O(log log n) шагов,
+// на сильно неравномерных — до O(n)
+inline bool interpolationSearch(const int* data, size_t n, int key) {
+    if (n == 0) return false;
+    size_t lo = 0, hi = n - 1;
+    while (lo <= hi && key >= data[lo] && key <= data[hi]) {
+        if (data[hi] == data[lo]) return data[lo] == key;
+        double fraction = (double(key) - data[lo]) / (double(data[hi]) - data[lo]);
+        size_t pos = lo + size_t(fraction * (hi - lo));
+        if (data[pos] == key) return true;
+        if (data[pos] < key) {
+            lo = pos + 1;
+        } else {
+            if (pos == 0) return false;
+            hi = pos - 1;
+        }
+    }
+    return false;
+}
+
+// B+-дерево: все ключи лежат в листьях, связанных в список для обхода диапазонов,
+// а внутренние узлы хранят только разделители. Узел занимает несколько кэш-линий,
+// поэтому высота дерева в 4-5 раз меньше, чем у AVL, и на каждый уровень приходится
+// один-два промаха кэша вместо одного промаха на каждое сравнение.
+class BPlusTree {
+private:
+    static const int LEAF_KEYS = 64;   // Ключей в листе: 256 байт ключей, 4 кэш-линии
+    static const int INNER_KEYS = 32;  // Разделителей во внутреннем узле (+33 указателя)
+    static const int LEAF_MIN = LEAF_KEYS / 2;    // Меньше — лист сливается или занимает у соседа
+    static const int INNER_MIN = INNER_KEYS / 2;
+
+    struct BNode {
+        int count = 0; // Сколько ключей занято
+        bool leaf;
+        explicit BNode(bool isLeaf) : leaf(isLeaf) {}
+    };
+    struct Leaf : BNode {
+        alignas(32) int keys[LEAF_KEYS]; // Незанятый хвост заполнен INT_MAX
+        Leaf* next = nullptr;            // Следующий лист (ключи больше)
+        Leaf() : BNode(true) { std::fill(keys, keys + LEAF_KEYS, INT_MAX); }
+    };
+    struct Inner : BNode {
+        alignas(32) int keys[INNER_KEYS];  // Разделители, незанятый хвост заполнен INT_MAX
+        BNode* children[INNER_KEYS + 1];   // children[i] — ключи из [keys[i-1], keys[i])
+        Inner() : BNode(false) { std::fill(keys, keys + INNER_KEYS, INT_MAX); }
+    };
+
+    BNode* root;
+    int height = 1; // Число уровней (у дерева из одного листа — 1)
+    std::vector<std::pair<Inner*, int>> path; // Внутренние узлы пути от корня и номер выбранного потомка
+
+    // Номер потомка, в котором может лежать key: число разделителей <= key
+    static int childIndex(const Inner* node, int key) {
+        return std::min(node->count, INNER_KEYS - countCompared<INNER_KEYS, true>(node->keys, key));
+    }
+
+    // Позиция первого ключа листа, не меньшего key
+    static int leafPosition(const Leaf* leaf, int key) {
+        return countCompared<LEAF_KEYS, false>(leaf->keys, key);
+    }
+
+    // Спуск к листу, в котором должен лежать key, с запоминанием пути
+    Leaf* descend(int key) {
+        path.clear();
+        BNode* node = root;
+        while (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            int i = childIndex(inner, key);
+            path.emplace_back(inner, i);
+            node = inner->children[i];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // Вставляет разделитель key и правого потомка child в позицию i внутреннего узла (место есть)
+    static void innerInsert(Inner* node, int i, int key, BNode* child) {
+        std::copy_backward(node->keys + i, node->keys + node->count, node->keys + node->count + 1);
+        std::copy_backward(node->children + i + 1, node->children + node->count + 1, node->children + node->count + 2);
+        node->keys[i] = key;
+        node->children[i + 1] = child;
+        node->count++;
+    }
+
+    // Удаляет разделитель i и правого от него потомка
+    static void innerErase(Inner* node, int i) {
+        std::copy(node->keys + i + 1, node->keys + node->count, node->keys + i);
+        std::copy(node->children + i + 2, node->children + node->count + 1, node->children + i + 1);
+        node->count--;
+        node->keys[node->count] = INT_MAX;
+    }
+
+    // Исправляет недозаполненный узел node — потомка parent с номером i:
+    // занимает ключ у соседа или сливается с ним. Возвращает true, если из parent удалён разделитель
+    bool fixUnderflow(Inner* parent, int i) {
+        BNode* node = parent->children[i];
+        BNode* left = i > 0 ? parent->children[i - 1] : nullptr;
+        BNode* right = i < parent->count ? parent->children[i + 1] : nullptr;
+        int minKeys = node->leaf ? LEAF_MIN : INNER_MIN;
+
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            Leaf* leftLeaf = static_cast<Leaf*>(left);
+            Leaf* rightLeaf = static_cast<Leaf*>(right);
+            if (leftLeaf && leftLeaf->count > minKeys) { // Берём последний ключ левого соседа
+                std::copy_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+                leaf->keys[0] = leftLeaf->keys[--leftLeaf->count];
+                leftLeaf->keys[leftLeaf->count] = INT_MAX;
+                leaf->count++;
+                parent->keys[i - 1] = leaf->keys[0];
+                return false;
+            }
+            if (rightLeaf && rightLeaf->count > minKeys) { // Берём первый ключ правого соседа
+                leaf->keys[leaf->count++] = rightLeaf->keys[0];
+                std::copy(rightLeaf->keys + 1, rightLeaf->keys + rightLeaf->count, rightLeaf->keys);
+                rightLeaf->keys[--rightLeaf->count] = INT_MAX;
+                parent->keys[i] = rightLeaf->keys[0];
+                return false;
+            }
+            // Сливаем пару соседних листов в левый
+            Leaf* target = leftLeaf ? leftLeaf : leaf;
+            Leaf* source = leftLeaf ? leaf : rightLeaf;
+            std::copy(source->keys, source->keys + source->count, target->keys + target->count);
+            target->count += source->count;
+            target->next = source->next;
+            innerErase(parent, leftLeaf ? i - 1 : i);
+            delete source;
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        if (left && left->count > minKeys) { // Разделитель родителя опускается, последний ключ соседа поднимается
+            Inner* from = static_cast<Inner*>(left);
+            innerInsert(inner, 0, parent->keys[i - 1], inner->children[0]);
+            inner->children[0] = from->children[from->count];
+            parent->keys[i - 1] = from->keys[from->count - 1];
+            from->keys[--from->count] = INT_MAX;
+            return false;
+        }
+        if (right && right->count > minKeys) { // Симметрично с правым соседом
+            Inner* from = static_cast<Inner*>(right);
+            inner->keys[inner->count] = parent->keys[i];
+            inner->children[++inner->count] = from->children[0];
+            parent->keys[i] = from->keys[0];
+            std::copy(from->keys + 1, from->keys + from->count, from->keys);
+            std::copy(from->children + 1, from->children + from->count + 1, from->children);
+            from->keys[--from->count] = INT_MAX;
+            return false;
+        }
+        // Сливаем: левый узел + разделитель родителя + правый узел
+        int separator = left ? i - 1 : i;
+        Inner* target = static_cast<Inner*>(left ? left : inner);
+        Inner* source = static_cast<Inner*>(left ? inner : right);
+        target->keys[target->count] = parent->keys[separator];
+        std::copy(source->keys, source->keys + source->count, target->keys + target->count + 1);
+        std::copy(source->children, source->children + source->count + 1, target->children + target->count + 1);
+        target->count += source->count + 1;
+        innerErase(parent, separator);
+        delete source;
+        return true;
+    }
+
+public:
+    BPlusTree() : root(new Leaf()) {}
+    ~BPlusTree() {
+        std::vector<BNode*> stack = {root}; // Высота мала, но обходим без рекурсии, как остальные деревья
+        while (!stack.empty()) {
+            BNode* node = stack.back();
+            stack.pop_back();
+            if (node->leaf) {
+                delete static_cast<Leaf*>(node);
+                continue;
+            }
+            Inner* inner = static_cast<Inner*>(node);
+            stack.insert(stack.end(), inner->children, inner->children + inner->count + 1);
+            delete inner;
+        }
+    }
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    void insert(int key) {
+        Leaf* leaf = descend(key);
+        int pos = leafPosition(leaf, key);
+        if (pos < leaf->count && leaf->keys[pos] == key) return; // Дубликаты игнорируются
+
+        if (leaf->count < LEAF_KEYS) {
+            std::copy_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            leaf->keys[pos] = key;
+            leaf->count++;
+            return;
+        }
+
+        // Лист полон: делим пополам, правая половина уходит в новый лист
+        int merged[LEAF_KEYS + 1];
+        std::copy(leaf->keys, leaf->keys + pos, merged);
+        merged[pos] = key;
+        std::copy(leaf->keys + pos, leaf->keys + LEAF_KEYS, merged + pos + 1);
+        Leaf* right = new Leaf();
+        int half = (LEAF_KEYS + 1) / 2;
+        std::copy(merged, merged + half, leaf->keys);
+        std::fill(leaf->keys + half, leaf->keys + LEAF_KEYS, INT_MAX);
+        leaf->count = half;
+        std::copy(merged + half, merged + LEAF_KEYS + 1, right->keys);
+        right->count = LEAF_KEYS + 1 - half;
+        right->next = leaf->next;
+        leaf->next = right;
+
+        // Поднимаем разделитель вверх по пути, деля переполненные внутренние узлы
+        int separator = right->keys[0];
+        BNode* child = right;
+        while (!path.empty()) {
+            auto [parent, i] = path.back();
+            path.pop_back();
+            if (parent->count < INNER_KEYS) {
+                innerInsert(parent, i, separator, child);
+                return;
+            }
+            int keys[INNER_KEYS + 1];
+            BNode* children[INNER_KEYS + 2];
+            std::copy(parent->keys, parent->keys + i, keys);
+            keys[i] = separator;
+            std::copy(parent->keys + i, parent->keys + INNER_KEYS, keys + i + 1);
+            std::copy(parent->children, parent->children + i + 1, children);
+            children[i + 1] = child;
+            std::copy(parent->children + i + 1, parent->children + INNER_KEYS + 1, children + i + 2);
+
+            int mid = INNER_KEYS / 2; // keys[mid] поднимается в родителя
+            Inner* sibling = new Inner();
+            std::copy(keys, keys + mid, parent->keys);
+            std::fill(parent->keys + mid, parent->keys + INNER_KEYS, INT_MAX);
+            std::copy(children, children + mid + 1, parent->children);
+            parent->count = mid;
+            std::copy(keys + mid + 1, keys + INNER_KEYS + 1, sibling->keys);
+            std::copy(children + mid + 1, children + INNER_KEYS + 2, sibling->children);
+            sibling->count = INNER_KEYS - mid;
+            separator = keys[mid];
+            child = sibling;
+        }
+
+        // Разделился корень: дерево растёт на уровень
+        Inner* newRoot = new Inner();
+        newRoot->keys[0] = separator;
+        newRoot->children[0] = root;
+        newRoot->children[1] = child;
+        newRoot->count = 1;
+        root = newRoot;
+        height++;
+    }
+
+    bool search(int key) {
+        const BNode* node = root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            node = inner->children[childIndex(inner, key)];
+        }
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        int pos = leafPosition(leaf, key);
+        return pos < leaf->count && leaf->keys[pos] == key;
+    }
+
+    void remove(int key) {
+        Leaf* leaf = descend(key);
+        int pos = leafPosition(leaf, key);
+        if (pos >= leaf->count || leaf->keys[pos] != key) return; // Ключа нет
+        std::copy(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        leaf->keys[--leaf->count] = INT_MAX;
+        // Разделители во внутренних узлах остаются верными границами и без обновления
+
+        BNode* node = leaf;
+        while (!path.empty() && node->count < (node->leaf ? LEAF_MIN : INNER_MIN)) {
+            auto [parent, i] = path.back();
+            path.pop_back();
+            if (!fixUnderflow(parent, i)) break;
+            node = parent;
+        }
+        if (!root->leaf && root->count == 0) { // У корня остался один потомок: дерево становится ниже
+            Inner* oldRoot = static_cast<Inner*>(root);
+            root = oldRoot->children[0];
+            delete oldRoot;
+            height--;
+        }
+    }
+
+    int getHeight() { return height; }
+
+    // Вызывает f(ключ) для всех ключей из [lo, hi] по возрастанию: один спуск, дальше по списку листьев
+    template <typename Func>
+    void forEachInRange(int lo, int hi, Func f) {
+        Leaf* leaf = descend(lo);
+        for (int pos = leafPosition(leaf, lo); leaf; leaf = leaf->next, pos = 0) {
+            for (; pos < leaf->count; ++pos) {
+                if (leaf->keys[pos] > hi) return;
+                f(leaf->keys[pos]);
+            }
+        }
+    }
+};
+
+// Генерация случайного массива с уникальными значениями (перестановка задаётся генератором gen)
+std::vector<int> generateRandomArray(int size, std::mt19937& gen) {
     std::vector<int> arr(size);
     for (int i = 0; i < size; ++i) arr[i] = i; // Заполняем числами от 0 до size-1
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::shuffle(arr.begin(), arr.end(), gen); // Перемешиваем для случайного порядка
     return arr;
 }
@@ -237,249 +1429,716 @@ std::vector<int> generateSortedArray(int size) {
     return arr;
 }
 
-// Замер времени вставки
-std::pair<double, double> measureInsertTime(BST& bst, AVL& avl, const std::vector<int>& arr) {
-    auto start = std::chrono::high_resolution_clock::now(); // Начало замера для BST
-    for (int num : arr) bst.insert(num);
-    auto end = std::chrono::high_resolution_clock::now(); // Конец замера для BST
-    std::chrono::duration<double> bstTime = end - start;
+// Замер времени вставки всех ключей в одно дерево (на одну операцию); подходит любое дерево с insert
+template <typename Tree>
+double measureInsertTime(Tree& tree, const std::vector<int>& arr) {
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    for (int num : arr) tree.insert(num);
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / arr.size(); // Время на одну операцию
+}
+
+// Замер времени удаления всего дерева (на один ключ, который в нём был)
+template <typename Tree>
+double measureTeardownTime(Tree& tree, size_t keys) {
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    tree.clear();
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / keys;
+}
+
+// Сколько байт кучи сейчас занято (по данным glibc); -1, если узнать нельзя
+long long heapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd; // Мелкие блоки + крупные, выделенные через mmap
+#else
+    return -1;
+#endif
+}
+
+// Замер времени построения дерева целиком из массива (на один ключ).
+// Отсортированный массив загружается напрямую, произвольный сначала сортируется
+template <typename Tree>
+double measureBulkLoadTime(Tree& tree, const std::vector<int>& arr, bool isSorted) {
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    if (isSorted) tree.build_from_sorted(arr);
+    else tree.build_from_unsorted(arr);
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / arr.size(); // Время на один ключ
+}
+
+// Сюда складываются результаты поиска, чтобы компилятор не выбросил "неиспользуемые" вызовы
+volatile int searchSink = 0;
 
-    start = std::chrono::high_resolution_clock::now(); // Начало замера для AVL
-    for (int num : arr) avl.insert(num);
-    end = std::chrono::high_resolution_clock::now(); // Конец замера для AVL
-    std::chrono::duration<double> avlTime = end - start;
+// Замер времени поиска в одном дереве
+template <typename Tree>
+double measureSearchTime(Tree& tree, const std::vector<int>& keys) {
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    int found = 0;
+    for (int key : keys) found += tree.search(key);
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    searchSink = found;
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / keys.size(); // Время на одну операцию
+}
 
-    return {bstTime.count() / arr.size(), avlTime.count() / arr.size()}; // Время на одну операцию
+// Замер времени пакетного поиска всех ключей одним вызовом search_batch
+template <typename Tree>
+double measureBatchSearchTime(Tree& tree, const std::vector<int>& keys) {
+    std::unique_ptr<bool[]> found(new bool[keys.size()]);
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    tree.search_batch(keys.data(), keys.size(), found.get());
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    searchSink = std::count(found.get(), found.get() + keys.size(), true);
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / keys.size(); // Время на одну операцию
 }
 
-// Замер времени поиска
-std::pair<double, double> measureSearchTime(BST& bst, AVL& avl, const std::vector<int>& keys) {
-    auto start = std::chrono::high_resolution_clock::now(); // Начало замера для BST
-    for (int key : keys) bst.search(key);
-    auto end = std::chrono::high_resolution_clock::now(); // Конец замера для BST
-    std::chrono::duration<double> bstTime = end - start;
+// Замер времени поиска в массиве способом mode. Для Branchless и Interpolation
+// массив должен быть отсортирован
+double measureArraySearchTime(const std::vector<int>& arr, const std::vector<int>& keys,
+                              ArraySearchMode mode = ArraySearchMode::Find) {
+    auto run = [&](auto search) {
+        auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+        int found = 0;
+        for (int key : keys) found += search(arr.data(), arr.size(), key);
+        auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+        searchSink = found;
+        std::chrono::duration<double> duration = end - start;
+        return duration.count() / keys.size(); // Время на одну операцию
+    };
+    switch (mode) {
+    case ArraySearchMode::SimdLinear:
+        return run([](const int* data, size_t n, int key) { return linearSearch(data, n, key); });
+    case ArraySearchMode::Branchless:
+        return run([](const int* data, size_t n, int key) { return branchlessSearch(data, n, key); });
+    case ArraySearchMode::Interpolation:
+        return run([](const int* data, size_t n, int key) { return interpolationSearch(data, n, key); });
+    default:
+        return run([](const int* data, size_t n, int key) { return std::find(data, data + n, key) != data + n; });
+    }
+}
 
-    start = std::chrono::high_resolution_clock::now(); // Начало замера для AVL
-    for (int key : keys) avl.search(key);
-    end = std::chrono::high_resolution_clock::now(); // Конец замера для AVL
-    std::chrono::duration<double> avlTime = end - start;
+// Замер времени удаления из одного дерева
+template <typename Tree>
+double measureDeleteTime(Tree& tree, const std::vector<int>& keys) {
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    for (int key : keys) tree.remove(key);
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / keys.size(); // Время на одну операцию
+}
 
-    return {bstTime.count() / keys.size(), avlTime.count() / keys.size()}; // Время на одну операцию
+// Замер времени поиска в неизменяемом дереве (построение в замер не входит)
+double measureStaticSearchTime(const StaticSearchTree& tree, const std::vector<int>& keys) {
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    int found = 0;
+    for (int key : keys) found += tree.search(key);
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    searchSink = found;
+    std::chrono::duration<double> duration = end - start;
+    return duration.count() / keys.size(); // Время на одну операцию
 }
 
-// Замер времени поиска в массиве
-double measureArraySearchTime(const std::vector<int>& arr, const std::vector<int>& keys) {
+// Замер времени запросов query(key) по всем ключам; query возвращает число, которое
+// накапливается, чтобы результат запроса не был выброшен компилятором
+template <typename Query>
+double measureQueryTime(const std::vector<int>& keys, Query query) {
     auto start = std::chrono::high_resolution_clock::now(); // Начало замера
-    for (int key : keys) std::find(arr.begin(), arr.end(), key); // Линейный поиск
+    long long total = 0;
+    for (int key : keys) total += query(key);
     auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    searchSink = int(total);
     std::chrono::duration<double> duration = end - start;
     return duration.count() / keys.size(); // Время на одну операцию
 }
 
-// Замер времени удаления
-std::pair<double, double> measureDeleteTime(BST& bst, AVL& avl, const std::vector<int>& keys) {
-    auto start = std::chrono::high_resolution_clock::now(); // Начало замера для BST
-    for (int key : keys) bst.remove(key);
-    auto end = std::chrono::high_resolution_clock::now(); // Конец замера для BST
-    std::chrono::duration<double> bstTime = end - start;
-
-    start = std::chrono::high_resolution_clock::now(); // Начало замера для AVL
-    for (int key : keys) avl.remove(key);
-    end = std::chrono::high_resolution_clock::now(); // Конец замера для AVL
-    std::chrono::duration<double> avlTime = end - start;
-
-    return {bstTime.count() / keys.size(), avlTime.count() / keys.size()}; // Время на одну операцию
-}
-
-int main() {
-    const int seriesCount = 10;        // Количество серий (всегда 10)
-    const int cyclesPerSeries = 20;    // Циклов в серии (10 случайных + 10 отсортированных для первых 5 серий)
-    const int operations = 1000;       // Количество операций поиска и удаления
-
-    // Открываем файлы для записи результатов
-    std::ofstream csvFile("results.csv");
-    csvFile << "Series,Size,DataType,Cycle,InsertBST,InsertAVL,SearchBST,SearchAVL,SearchArray,DeleteBST,DeleteAVL\n";
-
-    std::ofstream avgFile("averages.csv");
-    avgFile << "Size,DataType,InsertBST,InsertAVL,SearchBST,SearchAVL,SearchArray,DeleteBST,DeleteAVL\n";
-
-    // Основной цикл по сериям
-    for (int i = 0; i < seriesCount; ++i) {
-        int n = 1 << (10 + i); // Размер массива: 2^(10+i), от 1024 до 524288
-        std::cout << "Series " << i << ", Size = " << n << std::endl;
-
-        std::random_device rd; // Источник случайности
-        std::mt19937 gen(rd()); // Генератор случайных чисел
-
-        // Векторы для хранения времени операций (случайные данные)
-        std::vector<double> insertBSTTimesRandom(cyclesPerSeries / 2, 0.0);
-        std::vector<double> insertAVLTimesRandom(cyclesPerSeries / 2, 0.0);
-        std::vector<double> searchBSTTimesRandom(cyclesPerSeries / 2, 0.0);
-        std::vector<double> searchAVLTimesRandom(cyclesPerSeries / 2, 0.0);
-        std::vector<double> searchArrayTimesRandom(cyclesPerSeries / 2, 0.0);
-        std::vector<double> deleteBSTTimesRandom(cyclesPerSeries / 2, 0.0);
-        std::vector<double> deleteAVLTimesRandom(cyclesPerSeries / 2, 0.0);
-
-        // Тестирование случайных данных (10 циклов для всех серий)
-        std::cout << "Random Data:" << std::endl;
-        for (int j = 0; j < cyclesPerSeries / 2; ++j) {
-            std::vector<int> arr = generateRandomArray(n); // Генерируем случайный массив
-            BST bst; // Новое BST
-            AVL avl; // Новое AVL
-
-            // Замеряем время вставки (нормализуем на одну операцию)
-            auto [insertBST, insertAVL] = measureInsertTime(bst, avl, arr);
-
-            // Выводим высоту деревьев для случайных данных
-            std::cout << "Random Data - BST Height: " << bst.getHeight() << ", AVL Height: " << avl.getHeight() << std::endl;
-
-            // Генерируем ключи для поиска и удаления из исходного массива
-            std::vector<int> searchKeys = arr;
-            std::shuffle(searchKeys.begin(), searchKeys.end(), gen);
-            searchKeys.resize(operations); // Оставляем только 1000 ключей
-            std::vector<int> deleteKeys = arr;
-            std::shuffle(deleteKeys.begin(), deleteKeys.end(), gen);
-            deleteKeys.resize(operations); // Оставляем только 1000 ключей
-
-            // Замеряем время поиска и удаления
-            auto [searchBST, searchAVL] = measureSearchTime(bst, avl, searchKeys);
-            double arraySearch = measureArraySearchTime(arr, searchKeys);
-            auto [deleteBST, deleteAVL] = measureDeleteTime(bst, avl, deleteKeys);
-
-            // Сохраняем результаты для вычисления средних
-            insertBSTTimesRandom[j] = insertBST;
-            insertAVLTimesRandom[j] = insertAVL;
-            searchBSTTimesRandom[j] = searchBST;
-            searchAVLTimesRandom[j] = searchAVL;
-            searchArrayTimesRandom[j] = arraySearch;
-            deleteBSTTimesRandom[j] = deleteBST;
-            deleteAVLTimesRandom[j] = deleteAVL;
-
-            // Записываем в CSV
-            csvFile << i << "," << n << ",Random," << j << "," << insertBST << "," << insertAVL << ","
-                    << searchBST << "," << searchAVL << "," << arraySearch << "," << deleteBST << "," << deleteAVL << "\n";
-
-            // Выводим в консоль
-            std::cout << "Cycle " << j << " - Insert BST: " << insertBST << " s/op, Insert AVL: " << insertAVL << " s/op, "
-                      << "Search BST: " << searchBST << " s/op, Search AVL: " << searchAVL << " s/op, "
-                      << "Array Search: " << arraySearch << " s/op, "
-                      << "Delete BST: " << deleteBST << " s/op, Delete AVL: " << deleteAVL << " s/op" << std::endl;
-        }
-
-        // Вычисляем средние значения для случайных данных
-        double avgInsertBSTRandom = 0.0, avgInsertAVLRandom = 0.0;
-        double avgSearchBSTRandom = 0.0, avgSearchAVLRandom = 0.0, avgSearchArrayRandom = 0.0;
-        double avgDeleteBSTRandom = 0.0, avgDeleteAVLRandom = 0.0;
-        for (int j = 0; j < cyclesPerSeries / 2; ++j) {
-            avgInsertBSTRandom += insertBSTTimesRandom[j];
-            avgInsertAVLRandom += insertAVLTimesRandom[j];
-            avgSearchBSTRandom += searchBSTTimesRandom[j];
-            avgSearchAVLRandom += searchAVLTimesRandom[j];
-            avgSearchArrayRandom += searchArrayTimesRandom[j];
-            avgDeleteBSTRandom += deleteBSTTimesRandom[j];
-            avgDeleteAVLRandom += deleteAVLTimesRandom[j];
-        }
-        int halfCycles = cyclesPerSeries / 2;
-        avgInsertBSTRandom /= halfCycles;
-        avgInsertAVLRandom /= halfCycles;
-        avgSearchBSTRandom /= halfCycles;
-        avgSearchAVLRandom /= halfCycles;
-        avgSearchArrayRandom /= halfCycles;
-        avgDeleteBSTRandom /= halfCycles;
-        avgDeleteAVLRandom /= halfCycles;
-
-        // Записываем средние значения для случайных данных
-        avgFile << n << ",Random," << avgInsertBSTRandom << "," << avgInsertAVLRandom << ","
-                << avgSearchBSTRandom << "," << avgSearchAVLRandom << "," << avgSearchArrayRandom << ","
-                << avgDeleteBSTRandom << "," << avgDeleteAVLRandom << "\n";
-
-        // Тестирование отсортированных данных (только для первых 5 серий)
-        if (i < 5) {
-            std::vector<double> insertBSTTimesSorted(cyclesPerSeries / 2, 0.0);
-            std::vector<double> insertAVLTimesSorted(cyclesPerSeries / 2, 0.0);
-            std::vector<double> searchBSTTimesSorted(cyclesPerSeries / 2, 0.0);
-            std::vector<double> searchAVLTimesSorted(cyclesPerSeries / 2, 0.0);
-            std::vector<double> searchArrayTimesSorted(cyclesPerSeries / 2, 0.0);
-            std::vector<double> deleteBSTTimesSorted(cyclesPerSeries / 2, 0.0);
-            std::vector<double> deleteAVLTimesSorted(cyclesPerSeries / 2, 0.0);
-
-            std::cout << "Sorted Data:" << std::endl;
-            for (int j = 0; j < cyclesPerSeries / 2; ++j) {
-                std::vector<int> arr = generateSortedArray(n); // Генерируем отсортированный массив
-                BST bst; // Новое BST
-                AVL avl; // Новое AVL
-
-                // Замеряем время вставки
-                auto [insertBST, insertAVL] = measureInsertTime(bst, avl, arr);
-
-                // Выводим высоту деревьев для отсортированных данных
-                std::cout << "Sorted Data - BST Height: " << bst.getHeight() << ", AVL Height: " << avl.getHeight() << std::endl;
-
-                // Генерируем ключи для поиска и удаления из массива
-                std::vector<int> searchKeys = arr;
-                std::shuffle(searchKeys.begin(), searchKeys.end(), gen);
-                searchKeys.resize(operations); // Оставляем только 1000 ключей
-                std::vector<int> deleteKeys = arr;
-                std::shuffle(deleteKeys.begin(), deleteKeys.end(), gen);
-                deleteKeys.resize(operations); // Оставляем только 1000 ключей
-
-                // Замеряем время поиска и удаления
-                auto [searchBST, searchAVL] = measureSearchTime(bst, avl, searchKeys);
-                double arraySearch = measureArraySearchTime(arr, searchKeys);
-                auto [deleteBST, deleteAVL] = measureDeleteTime(bst, avl, deleteKeys);
-
-                // Сохраняем результаты
-                insertBSTTimesSorted[j] = insertBST;
-                insertAVLTimesSorted[j] = insertAVL;
-                searchBSTTimesSorted[j] = searchBST;
-                searchAVLTimesSorted[j] = searchAVL;
-                searchArrayTimesSorted[j] = arraySearch;
-                deleteBSTTimesSorted[j] = deleteBST;
-                deleteAVLTimesSorted[j] = deleteAVL;
-
-                // Записываем в CSV
-                csvFile << i << "," << n << ",Sorted," << j << "," << insertBST << "," << insertAVL << ","
-                        << searchBST << "," << searchAVL << "," << arraySearch << "," << deleteBST << "," << deleteAVL << "\n";
-
-                // Выводим в консоль
-                std::cout << "Cycle " << j << " - Insert BST: " << insertBST << " s/op, Insert AVL: " << insertAVL << " s/op, "
-                          << "Search BST: " << searchBST << " s/op, Search AVL: " << searchAVL << " s/op, "
-                          << "Array Search: " << arraySearch << " s/op, "
-                          << "Delete BST: " << deleteBST << " s/op, Delete AVL: " << deleteAVL << " s/op" << std::endl;
+// Гистограмма задержек в духе HdrHistogram: значения (в наносекундах) делятся по степеням двойки,
+// а каждая степень — на SUB_BUCKETS равных корзин. Ошибка любого процентиля не больше
+// 1/SUB_BUCKETS на любом масштабе, размер постоянный, гистограммы складываются поэлементно
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS; // 32 корзины на степень двойки: ошибка до 3%
+    static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+private:
+    uint64_t counts[BUCKETS] = {};
+    uint64_t total = 0;
+    uint64_t largestValue = 0;
+    double sum = 0;
+
+    static int bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) return int(value); // Малые значения хранятся точно
+        int top = SUB_BITS; // Номер старшего единичного бита
+        while (top < 63 && value >> (top + 1)) ++top;
+        int magnitude = top - SUB_BITS + 1;
+        return magnitude * SUB_BUCKETS + int(value >> (top - SUB_BITS)) - SUB_BUCKETS;
+    }
+
+    // Наибольшее значение, попадающее в корзину
+    static uint64_t bucketTop(int bucket) {
+        int magnitude = bucket / SUB_BUCKETS, sub = bucket % SUB_BUCKETS;
+        if (magnitude == 0) return sub;
+        return ((uint64_t(SUB_BUCKETS + sub) + 1) << (magnitude - 1)) - 1;
+    }
+
+public:
+    void record(uint64_t value) {
+        counts[bucketOf(value)]++;
+        total++;
+        largestValue = std::max(largestValue, value);
+        sum += double(value);
+    }
+
+    void add(const LatencyHistogram& other) {
+        for (int b = 0; b < BUCKETS; ++b) counts[b] += other.counts[b];
+        total += other.total;
+        largestValue = std::max(largestValue, other.largestValue);
+        sum += other.sum;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t largest() const { return largestValue; }
+    double mean() const { return total ? sum / total : 0.0; }
+
+    // Значение, которого не превышают p процентов записей (с точностью до корзины)
+    uint64_t percentile(double p) const {
+        uint64_t rank = std::max<uint64_t>(1, uint64_t(p / 100.0 * total + 0.5));
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return std::min(bucketTop(b), largestValue);
+        }
+        return largestValue;
+    }
+};
+
+// Цена пары вызовов часов (минимум из многих попыток); вычитается из каждой задержки
+uint64_t timerOverheadNs() {
+    static const uint64_t overhead = [] {
+        auto best = std::chrono::steady_clock::duration::max();
+        for (int i = 0; i < 1000; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, end - start);
+        }
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(best).count());
+    }();
+    return overhead;
+}
+
+// Задержка каждой операции op(key) по отдельности — в гистограмму. op возвращает число,
+// которое накапливается, чтобы вызов не был выброшен компилятором
+template <typename Op>
+void recordLatencies(const std::vector<int>& keys, Op op, LatencyHistogram& histogram) {
+    const uint64_t overhead = timerOverheadNs();
+    long long total = 0;
+    for (int key : keys) {
+        auto start = std::chrono::steady_clock::now();
+        total += op(key);
+        auto end = std::chrono::steady_clock::now();
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        histogram.record(ns > overhead ? ns - overhead : 0);
+    }
+    searchSink = int(total);
+}
+
+// Пропускная способность (операций в секунду) смешанной нагрузки из threads потоков.
+// Каждый поток делает opsPerThread операций: readPercent% — поиск, остальное поровну вставки
+// и удаления случайных ключей из [0, keyRange). Операции генерируются заранее, а потоки
+// стартуют одновременно, поэтому в замер попадает только работа с деревом
+template <typename Tree>
+double measureMixedThroughput(Tree& tree, int threads, int readPercent, int keyRange, int opsPerThread, std::mt19937& gen) {
+    struct Operation {
+        int kind; // 0 — поиск, 1 — вставка, 2 — удаление
+        int key;
+    };
+    std::vector<std::vector<Operation>> work(threads, std::vector<Operation>(opsPerThread));
+    std::uniform_int_distribution<int> keyDist(0, keyRange - 1), percentDist(0, 99);
+    for (auto& ops : work) {
+        for (Operation& op : ops) {
+            int roll = percentDist(gen);
+            op.kind = roll < readPercent ? 0 : 1 + roll % 2;
+            op.key = keyDist(gen);
+        }
+    }
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<long long> found{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready++;
+            while (!go.load()) std::this_thread::yield();
+            long long hits = 0;
+            for (const Operation& op : work[t]) {
+                if (op.kind == 0) hits += tree.search(op.key, t);
+                else if (op.kind == 1) tree.insert(op.key);
+                else tree.remove(op.key);
             }
+            found += hits;
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    auto start = std::chrono::high_resolution_clock::now(); // Начало замера
+    go = true;
+    for (std::thread& thread : pool) thread.join();
+    auto end = std::chrono::high_resolution_clock::now(); // Конец замера
+    searchSink = int(found.load());
+    std::chrono::duration<double> duration = end - start;
+    return double(threads) * opsPerThread / duration.count();
+}
+
+// Масштабирование по потокам: для каждой доли чтений и числа потоков 1, 2, 4, ..., maxThreads
+// три дерева заполняются n ключами и получают одну и ту же нагрузку. Результаты в concurrency.csv
+void runConcurrencyBenchmark(int n, int maxThreads, const std::vector<int>& readPercents, int opsPerThread,
+                             std::mt19937& gen) {
+    std::ofstream file("concurrency.csv");
+    file << "ReadPercent,Threads,Structure,OpsPerSecond\n";
+    std::vector<int> initial = generateRandomArray(n, gen);
+    for (int& key : initial) key *= 2; // Чётные ключи; нагрузка берёт ключи из [0, 2n), половина поисков успешна
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "Concurrent AVL, " << n << " keys, " << opsPerThread << " ops per thread:" << std::endl;
+    for (int readPercent : readPercents) {
+        for (int threads : threadCounts) {
+            uint32_t pointSeed = gen(); // Одинаковая нагрузка для всех структур в этой точке
+            auto run = [&](auto& tree, const std::string& name) {
+                for (int key : initial) tree.insert(key);
+                std::mt19937 workGen(pointSeed);
+                double throughput = measureMixedThroughput(tree, threads, readPercent, 2 * n, opsPerThread, workGen);
+                file << readPercent << "," << threads << "," << name << "," << throughput << "\n";
+                std::cout << "Reads " << readPercent << "%, threads " << threads << " - " << name << ": "
+                          << throughput << " ops/s" << std::endl;
+            };
+            {
+                LockedAVL<std::mutex> tree;
+                run(tree, "MutexAVL");
+            }
+            {
+                LockedAVL<std::shared_mutex> tree;
+                run(tree, "SharedMutexAVL");
+            }
+            {
+                auto tree = std::make_unique<ConcurrentAVL>(); // 4 КБ отметок читателей — не на стек
+                run(*tree, "ConcurrentAVL");
+            }
+        }
+    }
+    std::cout << "Concurrency results saved to concurrency.csv\n";
+}
+
+// Названия столбцов результатов; в этом же порядке они лежат в CycleResult::values.
+// Время — в секундах на операцию, BytesPerKey* — в байтах на ключ
+const std::vector<std::string> resultColumns = {
+    "InsertBST", "InsertAVL", "InsertPooled", "InsertBPlus", "BulkLoadBST", "BulkLoadAVL",
+    "SearchBST", "SearchAVL", "SearchPooled", "SearchBPlus", "BatchSearchBST", "BatchSearchAVL",
+    "SearchArray", "SearchArraySIMD", "SearchBranchless", "SearchInterpolation", "SearchEytzinger", "SearchVEB",
+    "RankAVL", "SelectAVL", "CountRangeAVL", "CountRangeArray",
+    "LowerBoundAVL", "LowerBoundArray", "RangeScanAVL", "RangeScanBPlus", "RangeScanArray",
+    "DeleteBST", "DeleteAVL", "DeletePooled", "DeleteBPlus",
+    "TeardownBST", "TeardownAVL", "TeardownPooled",
+    "BytesPerKeyBST", "BytesPerKeyAVL", "BytesPerKeyPooled"
+};
+
+// Деревья, для которых снимаются задержки отдельных операций, и сами операции
+const std::vector<std::string> treeNames = {"BST", "AVL", "Pooled", "BPlus"};
+const std::vector<std::string> latencyColumns = {
+    "InsertBST", "InsertAVL", "InsertPooled", "InsertBPlus",
+    "SearchBST", "SearchAVL", "SearchPooled", "SearchBPlus",
+    "DeleteBST", "DeleteAVL", "DeletePooled", "DeleteBPlus"
+};
+
+const int RANGE_WIDTH = 64; // Ширина диапазона для count_range и сканирования
+
+size_t columnIndex(const std::vector<std::string>& columns, const std::string& name) {
+    return std::find(columns.begin(), columns.end(), name) - columns.begin();
+}
+
+// Результаты одного цикла: значения resultColumns, гистограммы задержек latencyColumns и высоты
+// деревьев treeNames. Каждая структура заполняет только свои поля, остальные остаются нулями,
+// поэтому результаты, полученные в разных процессах, просто складываются
+struct CycleResult {
+    std::vector<double> values = std::vector<double>(resultColumns.size(), 0.0);
+    std::vector<LatencyHistogram> latencies = std::vector<LatencyHistogram>(latencyColumns.size());
+    std::vector<int> heights = std::vector<int>(treeNames.size(), 0);
+
+    void set(const std::string& column, double value) { values[columnIndex(resultColumns, column)] = value; }
+    LatencyHistogram& latency(const std::string& column) { return latencies[columnIndex(latencyColumns, column)]; }
+    void setHeight(const std::string& tree, int height) { heights[columnIndex(treeNames, tree)] = height; }
+
+    void add(const CycleResult& other) {
+        for (size_t c = 0; c < values.size(); ++c) values[c] += other.values[c];
+        for (size_t c = 0; c < latencies.size(); ++c) latencies[c].add(other.latencies[c]);
+        for (size_t c = 0; c < heights.size(); ++c) heights[c] += other.heights[c];
+    }
+};
+
+// Данные одного цикла, общие для всех структур. Генерируются заранее, поэтому в замеры
+// не попадают и не зависят от того, какие структуры и в каком порядке меряются
+struct Workload {
+    std::string dataType;        // "Random" или "Sorted"
+    std::vector<int> arr;        // Ключи в порядке вставки
+    std::vector<int> sorted;     // Те же ключи по возрастанию
+    std::vector<int> searchKeys; // Ключи для поиска; ключи — числа от 0 до n-1, поэтому они же номера для select
+    std::vector<int> deleteKeys; // Ключи для удаления
+};
 
-            // Вычисляем средние значения для отсортированных данных
-            double avgInsertBSTSorted = 0.0, avgInsertAVLSorted = 0.0;
-            double avgSearchBSTSorted = 0.0, avgSearchAVLSorted = 0.0, avgSearchArraySorted = 0.0;
-            double avgDeleteBSTSorted = 0.0, avgDeleteAVLSorted = 0.0;
-            for (int j = 0; j < cyclesPerSeries / 2; ++j) {
-                avgInsertBSTSorted += insertBSTTimesSorted[j];
-                avgInsertAVLSorted += insertAVLTimesSorted[j];
-                avgSearchBSTSorted += searchBSTTimesSorted[j];
-                avgSearchAVLSorted += searchAVLTimesSorted[j];
-                avgSearchArraySorted += searchArrayTimesSorted[j];
-                avgDeleteBSTSorted += deleteBSTTimesSorted[j];
-                avgDeleteAVLSorted += deleteAVLTimesSorted[j];
+Workload makeWorkload(int n, const std::string& dataType, int operations, std::mt19937& gen) {
+    Workload workload;
+    workload.dataType = dataType;
+    workload.arr = dataType == "Sorted" ? generateSortedArray(n) : generateRandomArray(n, gen);
+    workload.sorted = workload.arr;
+    std::sort(workload.sorted.begin(), workload.sorted.end());
+    workload.searchKeys = workload.arr;
+    std::shuffle(workload.searchKeys.begin(), workload.searchKeys.end(), gen);
+    workload.searchKeys.resize(operations); // Оставляем только 1000 ключей
+    workload.deleteKeys = workload.arr;
+    std::shuffle(workload.deleteKeys.begin(), workload.deleteKeys.end(), gen);
+    workload.deleteKeys.resize(operations); // Оставляем только 1000 ключей
+    return workload;
+}
+
+// Общая часть цикла для динамического дерева: вставка всех ключей, поиск, удаление и задержки
+// отдельных операций. Задержки снимаются отдельным проходом, чтобы вызовы часов не попали
+// в средние: поиск тех же ключей, затем повторная вставка удалённых ключей и их удаление.
+// extra(tree) вызывается на полном дереве до удалений. Возвращает прирост кучи при вставке (-1 — неизвестно)
+template <typename Tree, typename Extra>
+long long measureTreeCycle(Tree& tree, const std::string& name, const Workload& workload, CycleResult& result,
+                           Extra extra) {
+    long long heapBefore = heapBytesInUse();
+    result.set("Insert" + name, measureInsertTime(tree, workload.arr));
+    long long heapAfter = heapBytesInUse();
+    result.setHeight(name, tree.getHeight());
+
+    result.set("Search" + name, measureSearchTime(tree, workload.searchKeys));
+    extra(tree);
+    recordLatencies(workload.searchKeys, [&](int key) { return int(tree.search(key)); }, result.latency("Search" + name));
+
+    result.set("Delete" + name, measureDeleteTime(tree, workload.deleteKeys));
+    recordLatencies(workload.deleteKeys, [&](int key) { tree.insert(key); return 0; }, result.latency("Insert" + name));
+    recordLatencies(workload.deleteKeys, [&](int key) { tree.remove(key); return 0; }, result.latency("Delete" + name));
+    return heapBefore >= 0 ? heapAfter - heapBefore : -1;
+}
+
+void measureBSTCycle(const Workload& workload, CycleResult& result) {
+    BST bst;
+    long long heapGrowth = measureTreeCycle(bst, "BST", workload, result, [&](BST& tree) {
+        result.set("BatchSearchBST", measureBatchSearchTime(tree, workload.searchKeys));
+    });
+    result.set("TeardownBST", measureTeardownTime(bst, workload.arr.size()));
+    // Байт на ключ по приросту кучи (с учётом служебных данных malloc) или по размеру узла
+    result.set("BytesPerKeyBST", heapGrowth >= 0 ? double(heapGrowth) / workload.arr.size() : double(sizeof(Node)));
+
+    BST bulk; // Те же ключи, но дерево строится целиком из массива
+    result.set("BulkLoadBST", measureBulkLoadTime(bulk, workload.arr, workload.dataType == "Sorted"));
+}
+
+void measureAVLCycle(const Workload& workload, CycleResult& result) {
+    AVL avl;
+    long long heapGrowth = measureTreeCycle(avl, "AVL", workload, result, [&](AVL& tree) {
+        result.set("BatchSearchAVL", measureBatchSearchTime(tree, workload.searchKeys));
+
+        // Порядковые и диапазонные запросы (в массиве те же запросы меряет measureArrayCycle)
+        result.set("RankAVL", measureQueryTime(workload.searchKeys, [&](int key) { return tree.rank(key); }));
+        result.set("SelectAVL", measureQueryTime(workload.searchKeys, [&](int k) {
+            int key = 0;
+            tree.select(k, key);
+            return key;
+        }));
+        result.set("CountRangeAVL", measureQueryTime(workload.searchKeys, [&](int key) {
+            return tree.count_range(key, key + RANGE_WIDTH - 1);
+        }));
+        result.set("LowerBoundAVL", measureQueryTime(workload.searchKeys, [&](int key) {
+            auto it = tree.lower_bound(key);
+            return it != tree.end() ? *it : 0;
+        }));
+        result.set("RangeScanAVL", measureQueryTime(workload.searchKeys, [&](int key) { // Сумма ключей диапазона
+            long long sum = 0;
+            for (auto it = tree.lower_bound(key); it != tree.end() && *it < key + RANGE_WIDTH; ++it) sum += *it;
+            return sum;
+        }));
+    });
+    result.set("TeardownAVL", measureTeardownTime(avl, workload.arr.size()));
+    result.set("BytesPerKeyAVL", heapGrowth >= 0 ? double(heapGrowth) / workload.arr.size() : double(sizeof(Node)));
+
+    AVL bulk;
+    result.set("BulkLoadAVL", measureBulkLoadTime(bulk, workload.arr, workload.dataType == "Sorted"));
+}
+
+void measurePooledCycle(const Workload& workload, CycleResult& result) {
+    PooledAVL pooled;
+    measureTreeCycle(pooled, "Pooled", workload, result, [](PooledAVL&) {});
+    result.set("BytesPerKeyPooled", double(pooled.memoryBytes()) / workload.arr.size()); // Размер пула
+    result.set("TeardownPooled", measureTeardownTime(pooled, workload.arr.size()));
+}
+
+void measureBPlusCycle(const Workload& workload, CycleResult& result) {
+    BPlusTree bplus;
+    measureTreeCycle(bplus, "BPlus", workload, result, [&](BPlusTree& tree) {
+        // Тот же запрос, что RangeScanAVL: один спуск, затем проход по связанным листьям
+        result.set("RangeScanBPlus", measureQueryTime(workload.searchKeys, [&](int key) {
+            long long sum = 0;
+            tree.forEachInRange(key, key + RANGE_WIDTH - 1, [&sum](int k) { sum += k; });
+            return sum;
+        }));
+    });
+}
+
+// Поиск в массивах: линейный в исходном; двоичный, интерполяционный и неизменяемые деревья — в отсортированном
+void measureArrayCycle(const Workload& workload, CycleResult& result) {
+    const std::vector<int>& sorted = workload.sorted;
+    StaticSearchTree eytzinger(sorted, StaticLayout::Eytzinger);
+    StaticSearchTree veb(sorted, StaticLayout::VanEmdeBoas);
+    result.set("SearchArray", measureArraySearchTime(workload.arr, workload.searchKeys));
+    result.set("SearchArraySIMD", measureArraySearchTime(workload.arr, workload.searchKeys, ArraySearchMode::SimdLinear));
+    result.set("SearchBranchless", measureArraySearchTime(sorted, workload.searchKeys, ArraySearchMode::Branchless));
+    result.set("SearchInterpolation", measureArraySearchTime(sorted, workload.searchKeys, ArraySearchMode::Interpolation));
+    result.set("SearchEytzinger", measureStaticSearchTime(eytzinger, workload.searchKeys));
+    result.set("SearchVEB", measureStaticSearchTime(veb, workload.searchKeys));
+
+    result.set("CountRangeArray", measureQueryTime(workload.searchKeys, [&](int key) {
+        return std::upper_bound(sorted.begin(), sorted.end(), key + RANGE_WIDTH - 1) - std::lower_bound(sorted.begin(), sorted.end(), key);
+    }));
+    result.set("LowerBoundArray", measureQueryTime(workload.searchKeys, [&](int key) {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), key);
+        return it != sorted.end() ? *it : 0;
+    }));
+    result.set("RangeScanArray", measureQueryTime(workload.searchKeys, [&](int key) {
+        long long sum = 0;
+        for (auto it = std::lower_bound(sorted.begin(), sorted.end(), key); it != sorted.end() && *it < key + RANGE_WIDTH; ++it) sum += *it;
+        return sum;
+    }));
+}
+
+// Все структуры цикла в порядке замеров. Новая структура добавляется сюда и в списки столбцов
+using CycleMeasure = void (*)(const Workload&, CycleResult&);
+const std::vector<CycleMeasure> cycleMeasures = {
+    measureBSTCycle, measureAVLCycle, measurePooledCycle, measureBPlusCycle, measureArrayCycle
+};
+
+#if defined(__unix__)
+// Передача результатов через канал: write и read могут обработать только часть данных за вызов
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0) return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool readAll(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got <= 0) return false;
+        bytes += got;
+        size -= got;
+    }
+    return true;
+}
+
+static_assert(std::is_trivially_copyable<LatencyHistogram>::value, "histograms are sent as raw bytes");
+
+bool writeResult(int fd, const CycleResult& result) {
+    return writeAll(fd, result.values.data(), result.values.size() * sizeof(double)) &&
+           writeAll(fd, result.latencies.data(), result.latencies.size() * sizeof(LatencyHistogram)) &&
+           writeAll(fd, result.heights.data(), result.heights.size() * sizeof(int));
+}
+
+bool readResult(int fd, CycleResult& result) {
+    return readAll(fd, result.values.data(), result.values.size() * sizeof(double)) &&
+           readAll(fd, result.latencies.data(), result.latencies.size() * sizeof(LatencyHistogram)) &&
+           readAll(fd, result.heights.data(), result.heights.size() * sizeof(int));
+}
+#endif
+
+// Замер одной структуры в отдельном процессе (fork): всё, что она оставит в куче (фрагментация,
+// кэши malloc), исчезает вместе с процессом и не влияет на следующую структуру. Данные цикла
+// дочерний процесс видит без копирования, результаты возвращает через канал.
+// Если fork недоступен или не удался, замер идёт в этом процессе
+void runIsolated(CycleMeasure measure, const Workload& workload, CycleResult& result) {
+#if defined(__unix__)
+    int fds[2];
+    if (pipe(fds) == 0) {
+        std::cout.flush(); // Иначе несброшенный буфер вывода напечатают оба процесса
+        pid_t pid = fork();
+        if (pid == 0) { // Дочерний процесс
+            close(fds[0]);
+            CycleResult local;
+            measure(workload, local);
+            std::cout.flush();
+            _exit(writeResult(fds[1], local) ? 0 : 1);
+        }
+        close(fds[1]);
+        if (pid > 0) {
+            CycleResult child;
+            bool received = readResult(fds[0], child);
+            close(fds[0]);
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (received && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                result.add(child);
+                return;
             }
-            avgInsertBSTSorted /= halfCycles;
-            avgInsertAVLSorted /= halfCycles;
-            avgSearchBSTSorted /= halfCycles;
-            avgSearchAVLSorted /= halfCycles;
-            avgSearchArraySorted /= halfCycles;
-            avgDeleteBSTSorted /= halfCycles;
-            avgDeleteAVLSorted /= halfCycles;
-
-            // Записываем средние значения для отсортированных данных
-            avgFile << n << ",Sorted," << avgInsertBSTSorted << "," << avgInsertAVLSorted << ","
-                    << avgSearchBSTSorted << "," << avgSearchAVLSorted << "," << avgSearchArraySorted << ","
-                    << avgDeleteBSTSorted << "," << avgDeleteAVLSorted << "\n";
-        }
-    }
-
-    // Закрываем файлы и выводим сообщение
-    csvFile.close();
-    avgFile.close();
-    std::cout << "Results saved to results.csv\n";
-    std::cout << "Average values saved to averages.csv\n";
+            std::cerr << "Isolated measurement failed, measuring in this process" << std::endl;
+        } else {
+            close(fds[0]);
+        }
+    }
+#endif
+    measure(workload, result);
+}
+
+// Один цикл измерений: все структуры на данных workload (каждая в своём процессе при isolate)
+CycleResult runCycle(const Workload& workload, bool isolate) {
+    CycleResult result;
+    for (CycleMeasure measure : cycleMeasures) {
+        if (isolate) runIsolated(measure, workload, result);
+        else measure(workload, result);
+    }
+
+    // Выводим высоту деревьев
+    std::cout << workload.dataType << " Data -";
+    for (size_t t = 0; t < treeNames.size(); ++t) {
+        std::cout << (t ? ", " : " ") << treeNames[t] << " Height: " << result.heights[t];
+    }
+    std::cout << std::endl;
+    return result;
+}
+
+// Серия из cycles циклов для одного типа данных: строки в results.csv, среднее в averages.csv,
+// процентили задержек за всю серию в latency.csv. Данные всех циклов генерируются до замеров
+void runSeries(int series, int n, const std::string& dataType, int cycles, int operations, bool isolate,
+               std::mt19937& gen, std::ofstream& csvFile, std::ofstream& avgFile, std::ofstream& latencyFile) {
+    std::cout << dataType << " Data:" << std::endl;
+    std::vector<Workload> workloads;
+    for (int j = 0; j < cycles; ++j) workloads.push_back(makeWorkload(n, dataType, operations, gen));
+
+    std::vector<double> sums(resultColumns.size(), 0.0); // Суммы по столбцам для вычисления средних
+    std::vector<LatencyHistogram> latencies(latencyColumns.size()); // Задержки за все циклы серии
+    for (int j = 0; j < cycles; ++j) {
+        CycleResult result = runCycle(workloads[j], isolate);
+        const std::vector<double>& times = result.values;
+        for (size_t c = 0; c < latencies.size(); ++c) latencies[c].add(result.latencies[c]);
+
+        // Записываем в CSV и выводим в консоль
+        csvFile << series << "," << n << "," << dataType << "," << j;
+        std::cout << "Cycle " << j << " -";
+        for (size_t c = 0; c < times.size(); ++c) {
+            sums[c] += times[c];
+            csvFile << "," << times[c];
+            bool isBytes = resultColumns[c].rfind("BytesPerKey", 0) == 0;
+            std::cout << (c ? ", " : " ") << resultColumns[c] << ": " << times[c] << (isBytes ? " B/key" : " s/op");
+        }
+        csvFile << "\n";
+        std::cout << std::endl;
+    }
+
+    // Записываем средние значения
+    avgFile << n << "," << dataType;
+    for (double sum : sums) avgFile << "," << sum / cycles;
+    avgFile << "\n";
+
+    // Процентили задержек отдельных операций
+    for (size_t c = 0; c < latencies.size(); ++c) {
+        const LatencyHistogram& histogram = latencies[c];
+        latencyFile << series << "," << n << "," << dataType << "," << latencyColumns[c] << "," << histogram.count()
+                    << "," << histogram.mean() << "," << histogram.percentile(50) << "," << histogram.percentile(90)
+                    << "," << histogram.percentile(99) << "," << histogram.percentile(99.9) << "," << histogram.largest() << "\n";
+        std::cout << "Latency " << latencyColumns[c] << ": p50 " << histogram.percentile(50) << " ns, p99 "
+                  << histogram.percentile(99) << " ns, p99.9 " << histogram.percentile(99.9) << " ns, max "
+                  << histogram.largest() << " ns" << std::endl;
+    }
+}
+
+// Параметры: --seed=S — зерно генерации данных (по умолчанию фиксированное, поэтому повторный
+// запуск меряет те же данные); --fork — каждая структура меряется в отдельном процессе;
+// --threads=N — наибольшее число потоков в замере многопоточного AVL (по умолчанию число ядер);
+// --reads=P — доля поисков в процентах (по умолчанию 50, 90 и 99);
+// --skip-series — только многопоточный замер, без основных серий
+int main(int argc, char* argv[]) {
+    uint32_t seed = 20240521;
+    bool isolate = false;
+    int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> readPercents = {50, 90, 99};
+    bool runMainSeries = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--seed=", 0) == 0) {
+            seed = uint32_t(std::stoul(arg.substr(7)));
+        } else if (arg == "--fork") {
+            isolate = true;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            maxThreads = std::max(1, std::stoi(arg.substr(10)));
+        } else if (arg.rfind("--reads=", 0) == 0) {
+            readPercents = {std::clamp(std::stoi(arg.substr(8)), 0, 100)};
+        } else if (arg == "--skip-series") {
+            runMainSeries = false;
+        }
+    }
+    maxThreads = std::min(maxThreads, ConcurrentAVL::MAX_READERS); // У каждого потока своя отметка читателя
+    std::cout << "Seed: " << seed << (isolate ? ", each structure in its own process" : "") << std::endl;
+    std::cout << "SIMD search path (SearchArraySIMD, B+ nodes): " << simdPathName() << std::endl;
+
+    if (runMainSeries) {
+        const int seriesCount = 10;        // Количество серий (всегда 10)
+        const int cyclesPerSeries = 20;    // Циклов в серии (10 случайных + 10 отсортированных)
+        const int operations = 1000;       // Количество операций поиска и удаления
+
+        // Открываем файлы для записи результатов
+        std::ofstream csvFile("results.csv");
+        csvFile << "Series,Size,DataType,Cycle";
+        for (const std::string& column : resultColumns) csvFile << "," << column;
+        csvFile << "\n";
+
+        std::ofstream avgFile("averages.csv");
+        avgFile << "Size,DataType";
+        for (const std::string& column : resultColumns) avgFile << "," << column;
+        avgFile << "\n";
+
+        std::ofstream latencyFile("latency.csv");
+        latencyFile << "Series,Size,DataType,Operation,Count,Mean_ns,P50_ns,P90_ns,P99_ns,P999_ns,Max_ns\n";
+
+        // Основной цикл по сериям
+        for (int i = 0; i < seriesCount; ++i) {
+            int n = 1 << (10 + i); // Размер массива: 2^(10+i), от 1024 до 524288
+            std::cout << "Series " << i << ", Size = " << n << std::endl;
+
+            // Генератор серии зависит только от зерна и номера серии
+            std::seed_seq seriesSeed{seed, uint32_t(i)};
+            std::mt19937 gen(seriesSeed);
+
+            // Тестирование случайных данных (10 циклов для всех серий)
+            runSeries(i, n, "Random", cyclesPerSeries / 2, operations, isolate, gen, csvFile, avgFile, latencyFile);
+
+            // Тестирование отсортированных данных (10 циклов для всех серий)
+            runSeries(i, n, "Sorted", cyclesPerSeries / 2, operations, isolate, gen, csvFile, avgFile, latencyFile);
+        }
+
+        // Закрываем файлы и выводим сообщение
+        csvFile.close();
+        avgFile.close();
+        latencyFile.close();
+        std::cout << "Results saved to results.csv\n";
+        std::cout << "Average values saved to averages.csv\n";
+        std::cout << "Latency percentiles saved to latency.csv\n";
+    }
+
+    // Многопоточный AVL: смешанная нагрузка на дереве из 2^16 ключей
+    std::mt19937 gen(seed);
+    runConcurrencyBenchmark(1 << 16, maxThreads, readPercents, 200000, gen);
     return 0;
 }
@@ -6,6 +6,9 @@
 #include <random>
 #include <numeric>
 #include <map> // Добавляем для подсчёта частот
+#include <string>
+#include <tuple>
+#include <concepts>
 
 using namespace std;
 
@@ -49,16 +52,6 @@ public:
         return leafDepths;
     }
 
-    template <typename Func>
-    double measureTime(Func func, int operations, const vector<int>& keys) {
-        AVLTree tempTree(*this);
-        for (int i = 0; i < 1000; ++i) func(tempTree, keys[i % keys.size()]);
-        auto start = chrono::steady_clock::now();
-        for (int i = 0; i < operations; ++i) func(*this, keys[i % keys.size()]);
-        auto end = chrono::steady_clock::now();
-        return chrono::duration<double>(end - start).count() / operations;
-    }
-
 private:
     Node* root;
     int size;
@@ -220,16 +213,6 @@ public:
         return leafDepths;
     }
 
-    template <typename Func>
-    double measureTime(Func func, int operations, const vector<int>& keys) {
-        RandomizedBST tempTree(*this);
-        for (int i = 0; i < 1000; ++i) func(tempTree, keys[i % keys.size()]);
-        auto start = chrono::steady_clock::now();
-        for (int i = 0; i < operations; ++i) func(*this, keys[i % keys.size()]);
-        auto end = chrono::steady_clock::now();
-        return chrono::duration<double>(end - start).count() / operations;
-    }
-
 private:
     Node* root;
     int size;
@@ -355,6 +338,7 @@ public:
     ~RedBlackTree() { destroy(root); }
 
     void insert(int key) {
+        if (findNode(root, key)) return; // Как и в остальных деревьях, повторы игнорируются
         Node* node = new Node(key);
         root = insert(root, node);
         fixInsert(node);
@@ -378,16 +362,6 @@ public:
         return leafDepths;
     }
 
-    template <typename Func>
-    double measureTime(Func func, int operations, const vector<int>& keys) {
-        RedBlackTree tempTree(*this);
-        for (int i = 0; i < 1000; ++i) func(tempTree, keys[i % keys.size()]);
-        auto start = chrono::steady_clock::now();
-        for (int i = 0; i < operations; ++i) func(*this, keys[i % keys.size()]);
-        auto end = chrono::steady_clock::now();
-        return chrono::duration<double>(end - start).count() / operations;
-    }
-
 private:
     Node* root;
     int size;
@@ -606,233 +580,178 @@ private:
     }
 };
 
-// Функция для записи гистограммы в файл
-void writeHistogramToFile(const string& filename, const map<int, int>& histogram, const string& header) {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Failed to open " << filename << endl;
-        return;
-    }
-    file << header << "\n";
-    for (const auto& [value, count] : histogram) {
-        file << value << "," << count << "\n";
-    }
-    file.close();
-}
+// Упорядоченное множество целых ключей — всё, что нужно общему стенду замеров.
+// Копирование нужно для прогрева: операции сначала прогоняются на копии дерева
+template <typename T>
+concept OrderedSet = default_initializable<T> && copy_constructible<T> && requires(T set, int key) {
+    set.insert(key);
+    set.remove(key);
+    { set.search(key) } -> convertible_to<bool>;
+    { set.getMaxDepth() } -> convertible_to<int>;
+    { set.getSize() } -> convertible_to<int>;
+    { set.getLeafDepths() } -> convertible_to<vector<int>>;
+};
 
-int main() {
-    ofstream outFile("results_random.csv");
-    if (!outFile.is_open()) {
-        cerr << "Failed to open results_random.csv" << endl;
-        return 1;
-    }
-    outFile << "N,AVL Max Depth,AVL Avg Insert Time,AVL Avg Remove Time,AVL Avg Search Time,"
-            << "RBST Max Depth,RBST Avg Insert Time,RBST Avg Remove Time,RBST Avg Search Time,"
-            << "RB Max Depth,RB Avg Insert Time,RB Avg Remove Time,RB Avg Search Time\n";
+// Измеряемая структура: тип и имя в результатах
+template <OrderedSet S>
+struct Structure {
+    using Set = S;
+    string name;
+};
 
-    // Векторы для максимальных высот
-    vector<int> avlMaxHeightsLastSeries, rbstMaxHeightsLastSeries, rbMaxHeightsLastSeries;
-    // Векторы для всех глубин листьев за все итерации
-    vector<int> avlLeafDepthsLastSeries, rbstLeafDepthsLastSeries, rbLeafDepthsLastSeries;
+// Все измеряемые структуры. Новое дерево (любой класс, удовлетворяющий OrderedSet)
+// добавляется одной строкой здесь: замеры и CSV подхватывают его автоматически
+const auto structures = make_tuple(
+    Structure<AVLTree>{"AVL"},
+    Structure<RandomizedBST>{"RBST"},
+    Structure<RedBlackTree>{"RB"}
+);
+constexpr size_t structureCount = tuple_size_v<decltype(structures)>;
+
+// Вызывает func(структура, её номер) для каждой структуры по порядку
+template <typename Func>
+void forEachStructure(Func func) {
+    size_t index = 0;
+    std::apply([&](const auto&... structure) { (func(structure, index++), ...); }, structures);
+}
 
-    for (int i = 10; i <= 18; ++i) {
-        int N = 1 << i;
-        cout << "Running tests for N = " << N << " (Random Data)" << endl;
+// Операции, время которых меряется у каждой структуры (в этом порядке они идут в CSV)
+enum class Operation { Insert, Remove, Search };
+const vector<pair<Operation, string>> operations = {
+    {Operation::Insert, "Insert"}, {Operation::Remove, "Remove"}, {Operation::Search, "Search"}
+};
 
-        double totalInsertAVL = 0, totalRemoveAVL = 0, totalSearchAVL = 0;
-        double totalInsertRBST = 0, totalRemoveRBST = 0, totalSearchRBST = 0;
-        double totalInsertRB = 0, totalRemoveRB = 0, totalSearchRB = 0;
-        int maxDepthAVL = 0, maxDepthRBST = 0, maxDepthRB = 0;
+const int REPEATS = 50;              // Повторов в каждой серии
+const int MEASURED_OPERATIONS = 1000; // Операций в одном замере
+const int LAST_SERIES_POWER = 18;     // Для последней серии (N = 2^18) собираются гистограммы глубин
+
+// Сюда пишутся результаты поиска, чтобы компилятор не выбросил вызовы
+volatile bool searchSink = false;
+
+// Среднее время одной операции: прогрев на копии множества, затем count вызовов func
+// на самом множестве с ключами keys по кругу
+template <OrderedSet Set, typename Func>
+double measureTime(Set& set, Func func, int count, const vector<int>& keys) {
+    Set tempSet(set);
+    for (int i = 0; i < 1000; ++i) func(tempSet, keys[i % keys.size()]);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) func(set, keys[i % keys.size()]);
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count() / count;
+}
 
-        vector<int> testKeys(N);
-        for (int j = 0; j < N; ++j) testKeys[j] = j;
-        shuffle(testKeys.begin(), testKeys.end(), gen);
+template <OrderedSet Set>
+double measureOperation(Set& set, Operation operation, const vector<int>& keys) {
+    switch (operation) {
+    case Operation::Insert:
+        return measureTime(set, [](Set& s, int key) { s.insert(key); }, MEASURED_OPERATIONS, keys);
+    case Operation::Remove:
+        return measureTime(set, [](Set& s, int key) { s.remove(key); }, MEASURED_OPERATIONS, keys);
+    default:
+        return measureTime(set, [](Set& s, int key) { searchSink = s.search(key); }, MEASURED_OPERATIONS, keys);
+    }
+}
 
-        for (int repeat = 0; repeat < 50; ++repeat) {
-            cout << "Repeat " << repeat + 1 << " of 50 for N = " << N << endl;
+// Итоги одной структуры за серию (один размер N и один порядок данных)
+struct SeriesStats {
+    vector<double> totalTime = vector<double>(operations.size(), 0.0); // Сумма средних времён по повторам
+    int maxDepth = 0;
+    vector<int> maxDepths;  // Максимальная глубина каждого повтора (только в последней серии)
+    vector<int> leafDepths; // Глубины листьев всех повторов (только в последней серии)
+};
 
-            vector<int> values(N);
-            for (int j = 0; j < N; ++j) values[j] = j;
-            shuffle(values.begin(), values.end(), gen);
-
-            AVLTree avl_tree;
-            for (int v : values) avl_tree.insert(v);
-            totalInsertAVL += avl_tree.measureTime([](AVLTree& t, int val) { t.insert(val); }, 1000, testKeys);
-            totalRemoveAVL += avl_tree.measureTime([](AVLTree& t, int val) { t.remove(val); }, 1000, testKeys);
-            totalSearchAVL += avl_tree.measureTime([](AVLTree& t, int val) { t.search(val); }, 1000, testKeys);
-            maxDepthAVL = max(maxDepthAVL, avl_tree.getMaxDepth());
-
-            RandomizedBST rbst;
-            for (int v : values) rbst.insert(v);
-            totalInsertRBST += rbst.measureTime([](RandomizedBST& t, int val) { t.insert(val); }, 1000, testKeys);
-            totalRemoveRBST += rbst.measureTime([](RandomizedBST& t, int val) { t.remove(val); }, 1000, testKeys);
-            totalSearchRBST += rbst.measureTime([](RandomizedBST& t, int val) { t.search(val); }, 1000, testKeys);
-            maxDepthRBST = max(maxDepthRBST, rbst.getMaxDepth());
-
-            RedBlackTree rb_tree;
-            for (int v : values) rb_tree.insert(v);
-            totalInsertRB += rb_tree.measureTime([](RedBlackTree& t, int val) { t.insert(val); }, 1000, testKeys);
-            totalRemoveRB += rb_tree.measureTime([](RedBlackTree& t, int val) { t.remove(val); }, 1000, testKeys);
-            totalSearchRB += rb_tree.measureTime([](RedBlackTree& t, int val) { t.search(val); }, 1000, testKeys);
-            maxDepthRB = max(maxDepthRB, rb_tree.getMaxDepth());
-
-            if (i == 18) {
-                cout << "AVL size: " << avl_tree.getSize() << ", leaf count: " << avl_tree.getLeafDepths().size() << endl;
-                cout << "RBST size: " << rbst.getSize() << ", leaf count: " << rbst.getLeafDepths().size() << endl;
-                cout << "RB size: " << rb_tree.getSize() << ", leaf count: " << rb_tree.getLeafDepths().size() << endl;
-
-                avlMaxHeightsLastSeries.push_back(avl_tree.getMaxDepth());
-                rbstMaxHeightsLastSeries.push_back(rbst.getMaxDepth());
-                rbMaxHeightsLastSeries.push_back(rb_tree.getMaxDepth());
-
-                vector<int> leafDepthsAVL = avl_tree.getLeafDepths();
-                avlLeafDepthsLastSeries.insert(avlLeafDepthsLastSeries.end(), leafDepthsAVL.begin(), leafDepthsAVL.end());
-
-                vector<int> leafDepthsRBST = rbst.getLeafDepths();
-                rbstLeafDepthsLastSeries.insert(rbstLeafDepthsLastSeries.end(), leafDepthsRBST.begin(), leafDepthsRBST.end());
-
-                vector<int> leafDepthsRB = rb_tree.getLeafDepths();
-                rbLeafDepthsLastSeries.insert(rbLeafDepthsLastSeries.end(), leafDepthsRB.begin(), leafDepthsRB.end());
-            }
-        }
+// Один повтор для одной структуры: построение из values, замеры всех операций, глубины
+template <OrderedSet Set>
+void runRepeat(const string& name, const vector<int>& values, const vector<int>& testKeys, bool collectDepths,
+               SeriesStats& stats) {
+    Set set;
+    for (int v : values) set.insert(v);
+    for (size_t op = 0; op < operations.size(); ++op) {
+        stats.totalTime[op] += measureOperation(set, operations[op].first, testKeys);
+    }
+    int depth = set.getMaxDepth();
+    stats.maxDepth = max(stats.maxDepth, depth);
 
-        double avgInsertAVL = totalInsertAVL / 50, avgRemoveAVL = totalRemoveAVL / 50, avgSearchAVL = totalSearchAVL / 50;
-        double avgInsertRBST = totalInsertRBST / 50, avgRemoveRBST = totalRemoveRBST / 50, avgSearchRBST = totalSearchRBST / 50;
-        double avgInsertRB = totalInsertRB / 50, avgRemoveRB = totalRemoveRB / 50, avgSearchRB = totalSearchRB / 50;
-
-        outFile << N << "," << maxDepthAVL << "," << avgInsertAVL << "," << avgRemoveAVL << "," << avgSearchAVL << ","
-                << maxDepthRBST << "," << avgInsertRBST << "," << avgRemoveRBST << "," << avgSearchRBST << ","
-                << maxDepthRB << "," << avgInsertRB << "," << avgRemoveRB << "," << avgSearchRB << "\n";
-    }
-    outFile.close();
-
-    // Подсчёт частот максимальных высот
-    map<int, int> avlMaxHeightHist, rbstMaxHeightHist, rbMaxHeightHist;
-    for (int height : avlMaxHeightsLastSeries) avlMaxHeightHist[height]++;
-    for (int height : rbstMaxHeightsLastSeries) rbstMaxHeightHist[height]++;
-    for (int height : rbMaxHeightsLastSeries) rbMaxHeightHist[height]++;
-
-    // Запись гистограммы максимальных высот
-    writeHistogramToFile("AVL_max_heights_random.csv", avlMaxHeightHist, "AVL Height,Frequency");
-    writeHistogramToFile("RBST_max_heights_random.csv", rbstMaxHeightHist, "RBST Height,Frequency");
-    writeHistogramToFile("RB_max_heights_random.csv", rbMaxHeightHist, "RB Height,Frequency");
-
-    // Подсчёт частот высот веток
-    map<int, int> avlLeafDepthHist, rbstLeafDepthHist, rbLeafDepthHist;
-    for (int depth : avlLeafDepthsLastSeries) avlLeafDepthHist[depth]++;
-    for (int depth : rbstLeafDepthsLastSeries) rbstLeafDepthHist[depth]++;
-    for (int depth : rbLeafDepthsLastSeries) rbLeafDepthHist[depth]++;
-
-    // Запись гистограммы высот веток
-    writeHistogramToFile("AVL_leaf_depths_random.csv", avlLeafDepthHist, "AVL Depth,Frequency");
-    writeHistogramToFile("RBST_leaf_depths_random.csv", rbstLeafDepthHist, "RBST Depth,Frequency");
-    writeHistogramToFile("RB_leaf_depths_random.csv", rbLeafDepthHist, "RB Depth,Frequency");
-
-    // Для отсортированных данных
-    ofstream outFileSorted("results_sorted.csv");
-    if (!outFileSorted.is_open()) {
-        cerr << "Failed to open results_sorted.csv" << endl;
-        return 1;
+    if (collectDepths) {
+        vector<int> leafDepths = set.getLeafDepths();
+        cout << name << " size: " << set.getSize() << ", leaf count: " << leafDepths.size() << endl;
+        stats.maxDepths.push_back(depth);
+        stats.leafDepths.insert(stats.leafDepths.end(), leafDepths.begin(), leafDepths.end());
     }
-    outFileSorted << "N,AVL Max Depth,AVL Avg Insert Time,AVL Avg Remove Time,AVL Avg Search Time,"
-                  << "RBST Max Depth,RBST Avg Insert Time,RBST Avg Remove Time,RBST Avg Search Time,"
-                  << "RB Max Depth,RB Avg Insert Time,RB Avg Remove Time,RB Avg Search Time\n";
+}
 
-    vector<int> avlMaxHeightsLastSeriesSorted, rbstMaxHeightsLastSeriesSorted, rbMaxHeightsLastSeriesSorted;
-    vector<int> avlLeafDepthsLastSeriesSorted, rbstLeafDepthsLastSeriesSorted, rbLeafDepthsLastSeriesSorted;
+// Запись частот значений в общий CSV гистограмм
+void writeHistogramRows(ofstream& file, const string& dataOrder, const string& structure, const string& kind,
+                        const vector<int>& values) {
+    map<int, int> histogram;
+    for (int value : values) histogram[value]++;
+    for (const auto& [value, count] : histogram) {
+        file << dataOrder << "," << structure << "," << kind << "," << value << "," << count << "\n";
+    }
+}
 
-    for (int i = 10; i <= 18; ++i) {
+// Все серии для одного порядка данных: строки в results.csv, гистограммы последней серии в depth_histograms.csv
+void runDataOrder(const string& dataOrder, bool sorted, ofstream& results, ofstream& histograms) {
+    for (int i = 10; i <= LAST_SERIES_POWER; ++i) {
         int N = 1 << i;
-        cout << "Running tests for N = " << N << " (Sorted Data)" << endl;
-
-        double totalInsertAVL = 0, totalRemoveAVL = 0, totalSearchAVL = 0;
-        double totalInsertRBST = 0, totalRemoveRBST = 0, totalSearchRBST = 0;
-        double totalInsertRB = 0, totalRemoveRB = 0, totalSearchRB = 0;
-        int maxDepthAVL = 0, maxDepthRBST = 0, maxDepthRB = 0;
+        cout << "Running tests for N = " << N << " (" << dataOrder << " Data)" << endl;
+        bool lastSeries = i == LAST_SERIES_POWER;
+        vector<SeriesStats> stats(structureCount);
 
         vector<int> testKeys(N);
         for (int j = 0; j < N; ++j) testKeys[j] = j;
         shuffle(testKeys.begin(), testKeys.end(), gen);
 
-        for (int repeat = 0; repeat < 50; ++repeat) {
-            cout << "Repeat " << repeat + 1 << " of 50 for N = " << N << endl;
+        for (int repeat = 0; repeat < REPEATS; ++repeat) {
+            cout << "Repeat " << repeat + 1 << " of " << REPEATS << " for N = " << N << endl;
 
+            // Одни и те же данные для всех структур
             vector<int> values(N);
             for (int j = 0; j < N; ++j) values[j] = j;
+            if (!sorted) shuffle(values.begin(), values.end(), gen);
 
-            AVLTree avl_tree;
-            for (int v : values) avl_tree.insert(v);
-            totalInsertAVL += avl_tree.measureTime([](AVLTree& t, int val) { t.insert(val); }, 1000, testKeys);
-            totalRemoveAVL += avl_tree.measureTime([](AVLTree& t, int val) { t.remove(val); }, 1000, testKeys);
-            totalSearchAVL += avl_tree.measureTime([](AVLTree& t, int val) { t.search(val); }, 1000, testKeys);
-            maxDepthAVL = max(maxDepthAVL, avl_tree.getMaxDepth());
-
-            RandomizedBST rbst;
-            for (int v : values) rbst.insert(v);
-            totalInsertRBST += rbst.measureTime([](RandomizedBST& t, int val) { t.insert(val); }, 1000, testKeys);
-            totalRemoveRBST += rbst.measureTime([](RandomizedBST& t, int val) { t.remove(val); }, 1000, testKeys);
-            totalSearchRBST += rbst.measureTime([](RandomizedBST& t, int val) { t.search(val); }, 1000, testKeys);
-            maxDepthRBST = max(maxDepthRBST, rbst.getMaxDepth());
-
-            RedBlackTree rb_tree;
-            for (int v : values) rb_tree.insert(v);
-            totalInsertRB += rb_tree.measureTime([](RedBlackTree& t, int val) { t.insert(val); }, 1000, testKeys);
-            totalRemoveRB += rb_tree.measureTime([](RedBlackTree& t, int val) { t.remove(val); }, 1000, testKeys);
-            totalSearchRB += rb_tree.measureTime([](RedBlackTree& t, int val) { t.search(val); }, 1000, testKeys);
-            maxDepthRB = max(maxDepthRB, rb_tree.getMaxDepth());
-
-            if (i == 18) {
-                cout << "AVL size: " << avl_tree.getSize() << ", leaf count: " << avl_tree.getLeafDepths().size() << endl;
-                cout << "RBST size: " << rbst.getSize() << ", leaf count: " << rbst.getLeafDepths().size() << endl;
-                cout << "RB size: " << rb_tree.getSize() << ", leaf count: " << rb_tree.getLeafDepths().size() << endl;
-
-                avlMaxHeightsLastSeriesSorted.push_back(avl_tree.getMaxDepth());
-                rbstMaxHeightsLastSeriesSorted.push_back(rbst.getMaxDepth());
-                rbMaxHeightsLastSeriesSorted.push_back(rb_tree.getMaxDepth());
-
-                vector<int> leafDepthsAVL = avl_tree.getLeafDepths();
-                avlLeafDepthsLastSeriesSorted.insert(avlLeafDepthsLastSeriesSorted.end(), leafDepthsAVL.begin(), leafDepthsAVL.end());
-
-                vector<int> leafDepthsRBST = rbst.getLeafDepths();
-                rbstLeafDepthsLastSeriesSorted.insert(rbstLeafDepthsLastSeriesSorted.end(), leafDepthsRBST.begin(), leafDepthsRBST.end());
-
-                vector<int> leafDepthsRB = rb_tree.getLeafDepths();
-                rbLeafDepthsLastSeriesSorted.insert(rbLeafDepthsLastSeriesSorted.end(), leafDepthsRB.begin(), leafDepthsRB.end());
-            }
+            forEachStructure([&](const auto& structure, size_t index) {
+                using Set = typename decay_t<decltype(structure)>::Set;
+                runRepeat<Set>(structure.name, values, testKeys, lastSeries, stats[index]);
+            });
         }
 
-        double avgInsertAVL = totalInsertAVL / 50, avgRemoveAVL = totalRemoveAVL / 50, avgSearchAVL = totalSearchAVL / 50;
-        double avgInsertRBST = totalInsertRBST / 50, avgRemoveRBST = totalRemoveRBST / 50, avgSearchRBST = totalSearchRBST / 50;
-        double avgInsertRB = totalInsertRB / 50, avgRemoveRB = totalRemoveRB / 50, avgSearchRB = totalSearchRB / 50;
-
-        outFileSorted << N << "," << maxDepthAVL << "," << avgInsertAVL << "," << avgRemoveAVL << "," << avgSearchAVL << ","
-                      << maxDepthRBST << "," << avgInsertRBST << "," << avgRemoveRBST << "," << avgSearchRBST << ","
-                      << maxDepthRB << "," << avgInsertRB << "," << avgRemoveRB << "," << avgSearchRB << "\n";
+        forEachStructure([&](const auto& structure, size_t index) {
+            results << dataOrder << "," << N << "," << structure.name << "," << stats[index].maxDepth;
+            for (double total : stats[index].totalTime) results << "," << total / REPEATS;
+            results << "\n";
+            if (lastSeries) {
+                writeHistogramRows(histograms, dataOrder, structure.name, "MaxDepth", stats[index].maxDepths);
+                writeHistogramRows(histograms, dataOrder, structure.name, "LeafDepth", stats[index].leafDepths);
+            }
+        });
     }
-    outFileSorted.close();
-
-    // Подсчёт частот максимальных высот для отсортированных данных
-    map<int, int> avlMaxHeightHistSorted, rbstMaxHeightHistSorted, rbMaxHeightHistSorted;
-    for (int height : avlMaxHeightsLastSeriesSorted) avlMaxHeightHistSorted[height]++;
-    for (int height : rbstMaxHeightsLastSeriesSorted) rbstMaxHeightHistSorted[height]++;
-    for (int height : rbMaxHeightsLastSeriesSorted) rbMaxHeightHistSorted[height]++;
+}
 
-    // Запись гистограммы максимальных высот
-    writeHistogramToFile("AVL_max_heights_sorted.csv", avlMaxHeightHistSorted, "AVL Height,Frequency");
-    writeHistogramToFile("RBST_max_heights_sorted.csv", rbstMaxHeightHistSorted, "RBST Height,Frequency");
-    writeHistogramToFile("RB_max_heights_sorted.csv", rbMaxHeightHistSorted, "RB Height,Frequency");
+int main() {
+    // Одна строка на структуру, размер и порядок данных
+    ofstream results("results.csv");
+    if (!results.is_open()) {
+        cerr << "Failed to open results.csv" << endl;
+        return 1;
+    }
+    results << "DataOrder,N,Structure,MaxDepth";
+    for (const auto& [operation, name] : operations) results << ",Avg" << name << "Time";
+    results << "\n";
 
-    // Подсчёт частот высот веток для отсортированных данных
-    map<int, int> avlLeafDepthHistSorted, rbstLeafDepthHistSorted, rbLeafDepthHistSorted;
-    for (int depth : avlLeafDepthsLastSeriesSorted) avlLeafDepthHistSorted[depth]++;
-    for (int depth : rbstLeafDepthsLastSeriesSorted) rbstLeafDepthHistSorted[depth]++;
-    for (int depth : rbLeafDepthsLastSeriesSorted) rbLeafDepthHistSorted[depth]++;
+    // Частоты максимальных глубин и глубин листьев в последней серии
+    ofstream histograms("depth_histograms.csv");
+    if (!histograms.is_open()) {
+        cerr << "Failed to open depth_histograms.csv" << endl;
+        return 1;
+    }
+    histograms << "DataOrder,Structure,Kind,Depth,Frequency\n";
 
-    // Запись гистограммы высот веток
-    writeHistogramToFile("AVL_leaf_depths_sorted.csv", avlLeafDepthHistSorted, "AVL Depth,Frequency");
-    writeHistogramToFile("RBST_leaf_depths_sorted.csv", rbstLeafDepthHistSorted, "RBST Depth,Frequency");
-    writeHistogramToFile("RB_leaf_depths_sorted.csv", rbLeafDepthHistSorted, "RB Depth,Frequency");
+    runDataOrder("Random", false, results, histograms);
+    runDataOrder("Sorted", true, results, histograms);
 
+    results.close();
+    histograms.close();
     cout << "Results have been written to files." << endl;
     return 0;
 }